@@ -5,7 +5,7 @@ matplotlib.use("Agg")
 from matplotlib import pyplot
 
 root = sys.argv[1]
-schemes = ["advx", "advy", "difx", "dify", "pres"]
+schemes = ["advx", "advy", "difx", "dify", "pres", "advsl"]
 
 fig = pyplot.figure()
 ax = fig.add_subplot()
@@ -2,15 +2,55 @@
 #define ARRAY_H
 
 #include <stddef.h>
+#include "memory.h" // memory_arena_t
+#include "real.h" // real_t
+
+// flat view of an array allocated by array_init,
+//   whose element [j][i] is located at data[j * pitch + i],
+//   which is used by the kernels to avoid the indirection through row pointers
+//   and to let the compiler assume that different arrays do not alias (restrict)
+// NOTE: row-pointer tables (real_t **) remain available for tests and I/O
+typedef struct {
+  real_t * data;
+  size_t pitch;
+} array_view_t;
+
+// rows of the arrays are aligned to this size (in bytes, a cache line),
+//   and thus the pitch is a multiple of ARRAY_ALIGNMENT / sizeof(real_t)
+#define ARRAY_ALIGNMENT 64
+
+// tell the compiler that "ptr" (the data of a view) is aligned,
+//   so that aligned vector loads / stores can be emitted
+#if defined(__GNUC__)
+#define ARRAY_ASSUME_ALIGNED(ptr) __builtin_assume_aligned((ptr), ARRAY_ALIGNMENT)
+#else
+#define ARRAY_ASSUME_ALIGNED(ptr) (ptr)
+#endif
 
 extern int array_init(
     const size_t nx,
     const size_t ny,
-    double *** const array
+    real_t *** const array
+);
+
+extern int array_init_arena(
+    memory_arena_t * const arena,
+    const size_t nx,
+    const size_t ny,
+    real_t *** const array
+);
+
+extern size_t array_nbytes(
+    const size_t nx,
+    const size_t ny
+);
+
+extern array_view_t array_view(
+    real_t * const * const array
 );
 
 extern int array_finalize(
-    double *** const array
+    real_t *** const array
 );
 
 #endif // ARRAY_H
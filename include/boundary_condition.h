@@ -2,25 +2,26 @@
 #define BOUNDARY_CONDITION_H
 
 #include "domain.h" // domain_t
+#include "real.h" // real_t
 
 extern int impose_boundary_condition_ux_x(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 );
 
 extern int impose_boundary_condition_ux_y(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 );
 
 extern int impose_boundary_condition_uy_x(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 );
 
 extern int impose_boundary_condition_uy_y(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 );
 
 #endif // BOUNDARY_CONDITION_H
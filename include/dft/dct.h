@@ -2,6 +2,7 @@
 #define DCT_H
 
 #include <stddef.h> // size_t
+#include "real.h" // solver_real_t
 
 // planner
 typedef struct dct_plan_t dct_plan_t;
@@ -21,13 +22,13 @@ extern int dct_destroy_plan(
 // perform forward transform (DCT type 2)
 extern int dct_exec_f(
     dct_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 );
 
 // perform backward transform (DCT type 3)
 extern int dct_exec_b(
     dct_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 );
 
 #endif // DCT_H
@@ -2,6 +2,7 @@
 #define RDFT_H
 
 #include <stddef.h> // size_t
+#include "real.h" // solver_real_t
 
 // planner
 typedef struct rdft_plan_t rdft_plan_t;
@@ -24,7 +25,7 @@ extern int rdft_destroy_plan (
 //      Im(X[n/2-1]), Im(X[n/2-2]), ..., Im(X[2]), Im(X[1])
 extern int rdft_exec_f (
     rdft_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 );
 
 // perform backward transform
@@ -33,7 +34,7 @@ extern int rdft_exec_f (
 // out: x[0], x[1], ..., x[n-2], x[n-1]
 extern int rdft_exec_b (
     rdft_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 );
 
 #endif // RDFT_H
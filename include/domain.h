@@ -7,20 +7,59 @@
 #define X_PERIODIC true
 #define Y_PERIODIC false
 
+// lengths of the domain
+#define DOMAIN_LX 1.
+#define DOMAIN_LY 3.
+
+// the numbers of cells can be fixed at compile time
+//   ("make FIXED_NX=128 FIXED_NY=384 all"),
+//   in which case domain_init adopts them and
+//   the kernels see the numbers of cells and dx as constants,
+//   while the transforms and the tri-diagonal solvers
+//   are specialised to these sizes (see specialise.h)
+// NOTE: "domain" is referred to in either case to keep the signatures unchanged
+#if defined(FIXED_NX) && defined(FIXED_NY)
+#define DOMAIN_NX(domain) ((void)(domain), (size_t)(FIXED_NX))
+#define DOMAIN_NY(domain) ((void)(domain), (size_t)(FIXED_NY))
+#define DOMAIN_DX(domain) ((void)(domain), DOMAIN_LX / (FIXED_NX))
+#else
+#define DOMAIN_NX(domain) ((domain)->nx)
+#define DOMAIN_NY(domain) ((domain)->ny)
+#define DOMAIN_DX(domain) ((domain)->dx)
+#endif
+
 extern const size_t ux_imin;
 extern const size_t uy_jmin;
 
+// NOTE: the grid is uniform in x, while it can be stretched in y:
+//   yf : positions of cell faces (where uy is defined), 0 to ny + 1
+//   yc : positions of cell centers (where ux and p are defined), 0 to ny + 1
+//   dyf: distances between neighbouring cell faces, defined at cell centers, 0 to ny + 1
+//   dyc: distances between neighbouring cell centers, defined at cell faces, 1 to ny + 1
+//   halo cells are the mirror images of the boundary cells
 typedef struct {
   double lx;
   double ly;
   size_t nx;
   size_t ny;
   double dx;
-  double dy;
+  double * yf;
+  double * yc;
+  double * dyf;
+  double * dyc;
 } domain_t;
 
 extern int domain_init(
     domain_t * const domain
 );
 
+extern int domain_init_y(
+    const double stretching,
+    domain_t * const domain
+);
+
+extern int domain_finalize(
+    domain_t * const domain
+);
+
 #endif // DOMAIN_H
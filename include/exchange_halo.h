@@ -2,15 +2,16 @@
 #define EXCHANGE_HALO_H
 
 #include "domain.h" // domain_t
+#include "real.h" // real_t
 
 extern int exchange_halo_x(
     const domain_t * const domain,
-    double ** const array
+    real_t ** const array
 );
 
 extern int exchange_halo_y(
     const domain_t * const domain,
-    double ** const array
+    real_t ** const array
 );
 
 #endif // EXCHANGE_HALO_H
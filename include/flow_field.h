@@ -1,14 +1,59 @@
 #if !defined(FLOW_FIELD_H)
 #define FLOW_FIELD_H
 
+#include <stddef.h> // size_t
 #include "domain.h" // domain_t
+#include "real.h" // real_t
+#include "memory.h" // memory_arena_t
 
+// velocity face inside the band around the body,
+//   whose velocity is multiplied by "factor" (the averaged weight)
 typedef struct {
-  double ** ux;
-  double ** uy;
-  double **  p;
-  // penalty to enforce zero velocity
-  double ** weight;
+  size_t i;
+  size_t j;
+  double factor;
+} penalised_face_t;
+
+// list of the faces penalised by the body,
+//   which excludes the faces whose factors are exactly unity
+// NOTE: "impulse" is the momentum given to the fluid by the penalty
+//       since the last update of the body, which is used by free bodies
+typedef struct {
+  size_t nitems;
+  size_t capacity;
+  penalised_face_t * faces;
+  double impulse;
+} penalty_t;
+
+// range of cells [jlo:jhi][ilo:ihi]
+typedef struct {
+  size_t ilo;
+  size_t ihi;
+  size_t jlo;
+  size_t jhi;
+} cell_range_t;
+
+// circular body, whose weights differ from unity
+//   only inside the band of cells "band"
+typedef struct {
+  double radius;
+  double origin[2];
+  double center[2];
+  double velocity[2];
+  cell_range_t band;
+} body_t;
+
+typedef struct {
+  // ux, uy, p, and weight are stored contiguously in this arena
+  memory_arena_t * arena;
+  real_t ** ux;
+  real_t ** uy;
+  real_t **  p;
+  // penalty to enforce the velocity of the body
+  body_t body;
+  real_t ** weight;
+  penalty_t penalty_ux;
+  penalty_t penalty_uy;
 } flow_field_t;
 
 extern int flow_field_init(
@@ -16,6 +61,18 @@ extern int flow_field_init(
     flow_field_t * const flow_field
 );
 
+extern int flow_field_move_body(
+    const domain_t * const domain,
+    const double time,
+    const double dt,
+    flow_field_t * const flow_field
+);
+
+extern int flow_field_place_body(
+    const domain_t * const domain,
+    flow_field_t * const flow_field
+);
+
 extern int flow_field_finalize(
     flow_field_t * const flow_field
 );
@@ -2,6 +2,8 @@
 #define FLOW_SOLVER_H
 
 #include "domain.h" // domain_t
+#include "real.h" // real_t, solver_real_t
+#include "memory.h" // memory_arena_t
 #include "dft/dct.h" // dct_plan_t
 #include "dft/rdft.h" // rdft_plan_t
 #include "tridiagonal_solver.h" // tridiagonal_solver_plan_t
@@ -9,26 +11,63 @@
 // variables used to solve Poisson equations
 typedef struct {
   // buffers to store intermediate data
-  double * buf0;
-  double * buf1;
+  solver_real_t * buf0;
+  solver_real_t * buf1;
   // x direction: dft-related things
   // NOTE: rdft_plan is used when X_PERIODIC; otherwise dct_plan is used
   rdft_plan_t * rdft_plan;
   dct_plan_t * dct_plan;
   double dft_norm;
-  double * wavenumbers;
+  solver_real_t * wavenumbers;
   // y direction: tridiagonal_solver-related things
   tridiagonal_solver_plan_t * tridiagonal_solver_plan;
-  double * tridiagonal_solver_l;
-  double * tridiagonal_solver_c;
-  double * tridiagonal_solver_u;
+  solver_real_t * tridiagonal_solver_l;
+  solver_real_t * tridiagonal_solver_c;
+  solver_real_t * tridiagonal_solver_u;
 } poisson_solver_t;
 
+// one-dimensional discrete Laplacian (including boundary conditions)
+//   for the unknowns of a velocity component in one direction
 typedef struct {
-  double ** psi;
-  double ** dux;
-  double ** duy;
+  tridiagonal_solver_plan_t * tridiagonal_solver_plan;
+  solver_real_t * tridiagonal_solver_l;
+  solver_real_t * tridiagonal_solver_c;
+  solver_real_t * tridiagonal_solver_u;
+  solver_real_t * tridiagonal_solver_c_offsets;
+} diffusion_system_t;
+
+// variables used to treat diffusive terms implicitly,
+//   only initialised when IMPLICIT_DIFFUSION is enabled
+// NOTE: buffers of poisson_solver are shared
+typedef struct {
+  diffusion_system_t ux_x;
+  diffusion_system_t ux_y;
+  diffusion_system_t uy_x;
+  diffusion_system_t uy_y;
+} diffusion_solver_t;
+
+// advective and diffusive terms (per unit time) of the previous step,
+//   only initialised when TIME_MARCHING is TIME_MARCHING_AB2
+typedef struct {
+  // time-step size of the previous step, zero when not available
+  double dt;
+  real_t ** dux;
+  real_t ** duy;
+} history_t;
+
+typedef struct {
+  // psi, dux, duy, history, and the buffers of poisson_solver
+  //   are stored contiguously in this arena
+  memory_arena_t * arena;
+  // NOTE: psi is an alias of duy when LOW_MEMORY is enabled
+  real_t ** psi;
+  // velocity increments, which also serve as the registers
+  //   of the low-storage Runge-Kutta scheme
+  real_t ** dux;
+  real_t ** duy;
+  history_t history;
   poisson_solver_t poisson_solver;
+  diffusion_solver_t diffusion_solver;
 } flow_solver_t;
 
 extern int flow_solver_init(
@@ -2,14 +2,76 @@
 #define MEMORY_H
 
 #include <stddef.h> // size_t
+#include <stdbool.h> // bool
+
+// categories of allocations, whose footprints are reported separately
+typedef enum {
+  // flow fields and their statistics
+  MEMORY_TAG_FIELD  = 0,
+  // auxiliary buffers of the solvers (scratch, transforms, linear systems)
+  MEMORY_TAG_SOLVER = 1,
+  // buffers for input / output
+  MEMORY_TAG_IO     = 2,
+  // others (grid, small objects)
+  MEMORY_TAG_OTHER  = 3,
+  MEMORY_NTAGS      = 4,
+} memory_tag_t;
+
+typedef struct memory_arena_t memory_arena_t;
 
 extern void * memory_alloc(
     const size_t nitems,
+    const size_t size,
+    const memory_tag_t tag
+);
+
+extern void * memory_alloc_aligned(
+    const size_t nitems,
+    const size_t size,
+    const size_t alignment,
+    const memory_tag_t tag
+);
+
+extern void memory_first_touch(
+    void * const ptr,
+    const size_t nchunks,
     const size_t size
 );
 
+extern size_t memory_nthreads(
+    void
+);
+
+extern size_t memory_thread(
+    void
+);
+
+extern bool memory_in_parallel(
+    void
+);
+
 extern void memory_free(
     void * const ptr
 );
 
+extern memory_arena_t * memory_arena_init(
+    const size_t capacity,
+    const memory_tag_t tag
+);
+
+extern void * memory_arena_alloc(
+    memory_arena_t * const arena,
+    const size_t nitems,
+    const size_t size,
+    const size_t alignment
+);
+
+extern void memory_arena_finalize(
+    memory_arena_t ** const arena
+);
+
+extern void memory_report(
+    void
+);
+
 #endif // MEMORY_H
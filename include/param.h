@@ -3,4 +3,47 @@
 
 #define Re 1000.
 
+// treat diffusive terms implicitly (Crank-Nicolson, approximately factorised in x and y),
+//   which removes the diffusive time-step constraint
+#define IMPLICIT_DIFFUSION false
+
+// treat advective terms by the MacCormack-corrected semi-Lagrangian scheme,
+//   which is unconditionally stable and allows Courant numbers larger than unity
+// NOTE: only available with TIME_MARCHING_EULER
+#define SEMI_LAGRANGIAN_ADVECTION false
+
+// time-marching schemes
+//   EULER: Euler forward
+//   RK3  : three-stage low-storage Runge-Kutta (Williamson, 1980)
+//   AB2  : Adams-Bashforth with variable time-step sizes
+// NOTE: RK3 and AB2 allow larger time-step sizes (see decide_dt.c);
+//       AB2 roughly halves the cost per unit time,
+//       while RK3 saves less as it evaluates three stages per step;
+//       RK3 cannot be combined with IMPLICIT_DIFFUSION,
+//       and AB2 falls back to Euler forward for the first step after (re)start
+#define TIME_MARCHING_EULER 0
+#define TIME_MARCHING_RK3   1
+#define TIME_MARCHING_AB2   2
+#define TIME_MARCHING TIME_MARCHING_EULER
+
+// motion of the immersed body
+//   FIXED      : at rest
+//   OSCILLATING: prescribed sinusoidal motion in x
+//   FREE       : driven by gravity and the hydrodynamic force
+// NOTE: parameters are given in flow_field.c;
+//       only the cells around the body are updated as it moves
+#define BODY_MOTION_FIXED       0
+#define BODY_MOTION_OSCILLATING 1
+#define BODY_MOTION_FREE        2
+#define BODY_MOTION BODY_MOTION_FIXED
+
+// share the storage of the solver buffers whose lifetimes do not overlap
+//   within a step, which removes three field-sized arrays:
+//   the Poisson buffers (buf0 / buf1) reuse the increments (dux / duy),
+//     which are consumed by the end of the prediction,
+//   and the scalar potential (psi) reuses duy after the last transpose
+// NOTE: not available with IMPLICIT_DIFFUSION, SEMI_LAGRANGIAN_ADVECTION, or RK3,
+//       which need the increments and the buffers at the same time
+#define LOW_MEMORY false
+
 #endif // PARAM_H
@@ -0,0 +1,44 @@
+#if !defined(REAL_H)
+#define REAL_H
+
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+
+// floating-point types, which are chosen at build time
+//   (make PRECISION=double / single / mixed / refined):
+//   real_t       : flow fields and the arithmetic of the stencils
+//   solver_real_t: linear solvers (transforms and tri-diagonal systems),
+//                  i.e., the Poisson equation
+//
+//             real_t  solver_real_t
+//   double    double  double
+//   single    float   float
+//   mixed     float   double
+//   refined   double  float
+//
+// with "refined", the Poisson equation is solved in float
+//   and the solution is iteratively refined in double (see solve_poisson.c)
+//
+// NOTE: reductions (diagnostics and time-step size) are always evaluated in double,
+//       and the statistics are updated in double but stored as real_t
+#if defined(PRECISION_SINGLE)
+typedef float real_t;
+typedef float solver_real_t;
+#elif defined(PRECISION_MIXED)
+typedef float real_t;
+typedef double solver_real_t;
+#elif defined(PRECISION_REFINED)
+typedef double real_t;
+typedef float solver_real_t;
+#else
+typedef double real_t;
+typedef double solver_real_t;
+#endif
+
+// machine epsilon of solver_real_t
+#if defined(PRECISION_SINGLE) || defined(PRECISION_REFINED)
+#define SOLVER_REAL_EPSILON FLT_EPSILON
+#else
+#define SOLVER_REAL_EPSILON DBL_EPSILON
+#endif
+
+#endif // REAL_H
@@ -0,0 +1,29 @@
+#if !defined(SIMD_H)
+#define SIMD_H
+
+// kernels marked with SIMD_DISPATCH are compiled for several instruction sets
+//   (AVX-512, AVX2, and the baseline of the target),
+//   one of which is chosen by CPUID when the program is loaded,
+//   so that one binary uses the widest vectors available on each machine
+// NOTE: the baseline version is kept as the fallback and the reference;
+//       all versions give identical results
+//       as floating-point contractions are disabled (ISO C, -std=c99)
+// NOTE: disabled by "make SIMD_DISPATCH=false"
+#if !defined(SIMD_DISPATCH_DISABLED) && defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define SIMD_DISPATCH_ENABLED
+#endif
+#endif
+
+#if defined(SIMD_DISPATCH_ENABLED)
+#define SIMD_DISPATCH __attribute__((target_clones("avx512f", "avx2", "default")))
+#else
+#define SIMD_DISPATCH
+#endif
+
+// name of the instruction set used by the kernels on this machine
+extern const char * simd_isa(
+    void
+);
+
+#endif // SIMD_H
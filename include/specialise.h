@@ -0,0 +1,29 @@
+#if !defined(SPECIALISE_H)
+#define SPECIALISE_H
+
+// call "func" whose first argument is a length "nitems",
+//   passing the numbers of cells fixed at compile time
+//   ("make FIXED_NX=128 FIXED_NY=384 all", see domain.h) as literals when they match,
+//   so that the transforms and the tri-diagonal solvers,
+//   which are agnostic to the grid, are specialised to it
+// NOTE: only FIXED_NX and FIXED_NY are referred to,
+//       so that these libraries do not depend on the domain
+#if defined(FIXED_NX) && defined(FIXED_NY)
+#define SPECIALISE(func, nitems, ...)   \
+  do {                                  \
+    if (FIXED_NX == (nitems)) {         \
+      func(FIXED_NX, __VA_ARGS__);      \
+    } else if (FIXED_NY == (nitems)) {  \
+      func(FIXED_NY, __VA_ARGS__);      \
+    } else {                            \
+      func((nitems), __VA_ARGS__);      \
+    }                                   \
+  } while (0)
+#else
+#define SPECIALISE(func, nitems, ...)   \
+  do {                                  \
+    func((nitems), __VA_ARGS__);        \
+  } while (0)
+#endif
+
+#endif // SPECIALISE_H
@@ -0,0 +1,46 @@
+#if !defined(STATISTICS_H)
+#define STATISTICS_H
+
+#include <stddef.h> // size_t
+#include "domain.h" // domain_t
+#include "real.h" // real_t
+#include "flow_field.h" // flow_field_t
+#include "memory.h" // memory_arena_t
+
+// running statistics of flow fields (Welford's algorithm)
+//   "mean" is the running average and "m2" is the sum of squared deviations,
+//   i.e., variance = m2 / nsamples
+// NOTE: ux, uy, and p are accumulated at their own positions,
+//       while the co-moment of ux and uy is accumulated at cell centers
+//       using the interpolated velocities (uxc, uyc)
+typedef struct {
+  size_t nsamples;
+  // all arrays are stored contiguously in this arena
+  memory_arena_t * arena;
+  real_t ** ux_mean;
+  real_t ** ux_m2;
+  real_t ** uy_mean;
+  real_t ** uy_m2;
+  real_t **  p_mean;
+  real_t **  p_m2;
+  real_t ** uxc_mean;
+  real_t ** uyc_mean;
+  real_t ** uxuy_m2;
+} statistics_t;
+
+extern int statistics_init(
+    const domain_t * const domain,
+    statistics_t * const statistics
+);
+
+extern int statistics_update(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    statistics_t * const statistics
+);
+
+extern int statistics_finalize(
+    statistics_t * const statistics
+);
+
+#endif // STATISTICS_H
@@ -3,6 +3,7 @@
 
 #include <stddef.h> // size_t
 #include <stdbool.h> // bool
+#include "real.h" // solver_real_t
 
 typedef struct tridiagonal_solver_internal_t tridiagonal_solver_internal_t;
 
@@ -26,13 +27,13 @@ extern int tridiagonal_solver_init_plan(
 extern int tridiagonal_solver_exec(
     tridiagonal_solver_plan_t * const tridiagonal_solver_plan,
     // tri-diagonal matrix, lower, center, upper-diagonals
-    const double * const l,
-    const double * const c,
-    const double * const u,
+    const solver_real_t * const l,
+    const solver_real_t * const c,
+    const solver_real_t * const u,
     // offset for center-diagonal components, can vary for each repeat
-    const double * const c_offsets,
+    const solver_real_t * const c_offsets,
     // input and output
-    double * const q
+    solver_real_t * const q
 );
 
 extern int tridiagonal_solver_destroy_plan(
@@ -1,25 +1,130 @@
+// madvise, MADV_HUGEPAGE
+#define _DEFAULT_SOURCE
+
+#include <assert.h> // assert
+#include <stdint.h> // uintptr_t
+#include <stdbool.h> // bool, false
+#include <sys/mman.h> // madvise
 #include "memory.h"
 #include "array.h"
 
-int array_init(
+// back large arrays by transparent huge pages to reduce TLB misses
+// NOTE: only effective when THP is set to "madvise" or "always",
+//       and costs up to one huge page of padding per array
+#define HUGE_PAGES false
+
+static const size_t huge_page_size = 2 << 20;
+
+// number of cache lines by which the first rows of the successive arrays are shifted,
+//   so that the same element of different arrays does not fall in the same cache set
+static const size_t nstaggers = 8;
+
+// number of cache lines per row is made odd,
+//   so that vertically-neighbouring elements do not fall in the same cache set
+//   (power-of-two aliasing), which is typical for nx = 2^n
+static size_t find_pitch(
+    const size_t nx
+) {
+  const size_t nitems_per_line = ARRAY_ALIGNMENT / sizeof(real_t);
+  size_t nlines = (nx + nitems_per_line - 1) / nitems_per_line;
+  if (0 == nlines % 2) {
+    nlines += 1;
+  }
+  return nlines * nitems_per_line;
+}
+
+// NOTE: the row-pointer table is preceded by a hidden element
+//       which keeps the address of the allocated buffer,
+//       as it differs from the first row due to the stagger
+static int init(
+    memory_arena_t * const arena,
     const size_t nx,
     const size_t ny,
-    double *** const array
+    real_t *** const array
 ) {
-  double * const buffer = memory_alloc(nx * ny, sizeof(double));
-  *array = memory_alloc(ny, sizeof(double *));
+  // NOTE: arrays are allocated serially
+  static size_t counter = 0;
+  const size_t pitch = find_pitch(nx);
+  const size_t offset = (counter++ % nstaggers) * ARRAY_ALIGNMENT / sizeof(real_t);
+  const size_t nitems = pitch * ny + offset;
+  const bool use_huge_pages = HUGE_PAGES && huge_page_size <= nitems * sizeof(real_t);
+  const size_t alignment = use_huge_pages ? huge_page_size : ARRAY_ALIGNMENT;
+  real_t * const buffer = NULL == arena
+    ? memory_alloc_aligned(nitems, sizeof(real_t), alignment, MEMORY_TAG_FIELD)
+    : memory_arena_alloc(arena, nitems, sizeof(real_t), alignment);
+#if defined(MADV_HUGEPAGE)
+  if (use_huge_pages) {
+    // NOTE: merely a hint, failure is harmless
+    madvise(buffer, nitems * sizeof(real_t) / huge_page_size * huge_page_size, MADV_HUGEPAGE);
+  }
+#endif
+  // NOTE: rows are distributed over the threads as in the kernels,
+  //       while the leading padding belongs to the first row
+  memory_first_touch(buffer + offset, ny, pitch * sizeof(real_t));
+  for (size_t n = 0; n < offset; n++) {
+    buffer[n] = 0.;
+  }
+  real_t ** const table = NULL == arena
+    ? memory_alloc(ny + 1, sizeof(real_t *), MEMORY_TAG_FIELD)
+    : memory_arena_alloc(arena, ny + 1, sizeof(real_t *), ARRAY_ALIGNMENT);
+  table[0] = buffer;
+  *array = table + 1;
   for (size_t j = 0; j < ny; j++) {
-    (*array)[j] = buffer + nx * j;
+    (*array)[j] = buffer + offset + pitch * j;
   }
+  assert(0 == (uintptr_t)(*array)[0] % ARRAY_ALIGNMENT);
+  assert(0 == pitch * sizeof(real_t) % ARRAY_ALIGNMENT);
   return 0;
 }
 
+// allocate an array on its own, which is accounted as a field
+int array_init(
+    const size_t nx,
+    const size_t ny,
+    real_t *** const array
+) {
+  return init(NULL, nx, ny, array);
+}
+
+// allocate an array in an arena, which is released with the arena
+//   and thus array_finalize is not needed
+int array_init_arena(
+    memory_arena_t * const arena,
+    const size_t nx,
+    const size_t ny,
+    real_t *** const array
+) {
+  return init(arena, nx, ny, array);
+}
+
+// number of bytes needed to store an array in an arena (upper bound),
+//   which is used to reserve a contiguous region for related arrays
+size_t array_nbytes(
+    const size_t nx,
+    const size_t ny
+) {
+  const size_t nitems = find_pitch(nx) * ny + (nstaggers - 1) * ARRAY_ALIGNMENT / sizeof(real_t);
+  // NOTE: headers and alignments of the data and the row-pointer table
+  const size_t margin = 4 * ARRAY_ALIGNMENT;
+  return nitems * sizeof(real_t) + (ny + 1) * sizeof(real_t *) + margin;
+}
+
+// NOTE: rows are equally spaced in the buffer
+array_view_t array_view(
+    real_t * const * const array
+) {
+  return (array_view_t){
+    .data = array[0],
+    .pitch = (size_t)(array[1] - array[0]),
+  };
+}
+
 int array_finalize(
-    double *** const array
+    real_t *** const array
 ) {
-  memory_free((*array)[0]);
-  memory_free(*array);
+  real_t ** const table = *array - 1;
+  memory_free(table[0]);
+  memory_free(table);
   *array = NULL;
   return 0;
 }
-
@@ -4,14 +4,14 @@
 
 int impose_boundary_condition_ux_x(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 ) {
   if (X_PERIODIC) {
     LOGGER_FAILURE("x direction is periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   for (size_t j = 0; j <= ny + 1; j++) {
     ux[j][     0] = 0.;
     ux[j][     1] = 0.;
@@ -24,14 +24,14 @@ abort:
 
 int impose_boundary_condition_ux_y(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 ) {
   if (Y_PERIODIC) {
     LOGGER_FAILURE("y direction is periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   const double ux_ym = 0.;
   const double ux_yp = 0.;
   for (size_t i = 0; i <= nx + 1; i++) {
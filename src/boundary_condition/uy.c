@@ -4,14 +4,14 @@
 
 int impose_boundary_condition_uy_x(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 ) {
   if (X_PERIODIC) {
     LOGGER_FAILURE("x direction is periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   const double uy_xm = 0.;
   const double uy_xp = 0.;
   for (size_t j = 0; j <= ny + 1; j++) {
@@ -25,14 +25,14 @@ abort:
 
 int impose_boundary_condition_uy_y(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 ) {
   if (Y_PERIODIC) {
     LOGGER_FAILURE("y direction is periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   for (size_t i = 0; i <= nx + 1; i++) {
     uy[     0][i] = uy[1][i];
     uy[ny + 1][i] = -1.;
@@ -1,6 +1,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include "memory.h"
+#include "specialise.h" // SPECIALISE
 #include "dft/dct.h"
 
 // discrete cosine transforms of type 2 and 3, Lee 1984
@@ -17,54 +19,42 @@ struct dct_plan_t {
   // trigonometric table
   //   1 / (2 cos( (pi i) / (2 N) ))
   //   where i = 0, 1, ..., N - 1
-  double * table;
-  // internal buffer
-  double * buf;
+  solver_real_t * table;
+  // internal buffer, one signal per thread
+  solver_real_t * buf;
+  // number of threads for which the buffer is reserved
+  size_t nthreads;
 };
 
-static void * memory_alloc(
-    const size_t size
-) {
-  void * const ptr = malloc(size);
-  if (NULL == ptr) {
-    fprintf(stderr, "[dct FATAL] failed to allocate %zu bytes\n", size);
-    return NULL;
-  }
-  return ptr;
-}
-
-static void memory_free(
-    void * const ptr
-) {
-  free(ptr);
-}
+// cache line
+static const size_t alignment = 64;
 
 static int dct2(
     const size_t nitems,
     const size_t inv,
-    const double * const restrict table,
-    double * const restrict xs,
-    double * const restrict ys
+    const solver_real_t * const restrict table,
+    solver_real_t * const restrict xs,
+    solver_real_t * const restrict ys
 ) {
   if (1 == nitems) {
   } else if (2 == nitems) {
-		const double v0 = xs[0];
-		const double v1 = xs[1];
+		const solver_real_t v0 = xs[0];
+		const solver_real_t v1 = xs[1];
 		xs[0] = 1.     * v0 + 1.     * v1;
 		xs[1] = sqrt2h * v0 - sqrt2h * v1;
   } else if (3 == nitems) {
-    const double v0 = xs[0];
-    const double v1 = xs[1];
-    const double v2 = xs[2];
+    const solver_real_t v0 = xs[0];
+    const solver_real_t v1 = xs[1];
+    const solver_real_t v2 = xs[2];
     xs[0] = 1.     * v0 + 1. * v1 + 1.     * v2;
     xs[1] = sqrt3h * v0           - sqrt3h * v2;
     xs[2] = 0.5    * v0 - 1. * v1 + 0.5    * v2;
   } else if (0 == nitems % 2) {
     const size_t nhalfs = nitems / 2;
     for (size_t i = 0; i < nhalfs; i++) {
-      const double c = table[(2 * i + 1) * inv];
-      const double v0 = xs[             i];
-      const double v1 = xs[nitems - 1 - i];
+      const solver_real_t c = table[(2 * i + 1) * inv];
+      const solver_real_t v0 = xs[             i];
+      const solver_real_t v1 = xs[nitems - 1 - i];
       ys[i         ] = 1. * (v0 + v1);
       ys[i + nhalfs] = c  * (v0 - v1);
     }
@@ -80,7 +70,7 @@ static int dct2(
   } else {
     // fallback to N^2 DCT2
     for (size_t j = 0; j < nitems; j++) {
-      double * y = ys + j;
+      solver_real_t * y = ys + j;
       *y = 0.;
       for (size_t i = 0; i < nitems; i++) {
         const double phase = pi * (2. * i + 1.) * j / (2. * nitems);
@@ -97,20 +87,20 @@ static int dct2(
 static int dct3(
     const size_t nitems,
     const size_t inv,
-    const double * const restrict table,
-    double * const restrict xs,
-    double * const restrict ys
+    const solver_real_t * const restrict table,
+    solver_real_t * const restrict xs,
+    solver_real_t * const restrict ys
 ) {
   if (1 == nitems) {
   } else if (2 == nitems) {
-    const double v0 = xs[0];
-    const double v1 = xs[1];
+    const solver_real_t v0 = xs[0];
+    const solver_real_t v1 = xs[1];
     xs[0] = v0 + sqrt2h * v1;
     xs[1] = v0 - sqrt2h * v1;
   } else if (3 == nitems) {
-    const double v0 = xs[0];
-    const double v1 = xs[1];
-    const double v2 = xs[2];
+    const solver_real_t v0 = xs[0];
+    const solver_real_t v1 = xs[1];
+    const solver_real_t v2 = xs[2];
     xs[0] = v0 + sqrt3h * v1 + 0.5 * v2;
     xs[1] = v0               -       v2;
     xs[2] = v0 - sqrt3h * v1 + 0.5 * v2;
@@ -126,16 +116,16 @@ static int dct3(
     dct3(nhalfs, inv * 2, table, ys         , xs);
     dct3(nhalfs, inv * 2, table, ys + nhalfs, xs);
     for (size_t i = 0; i < nhalfs; i++) {
-      const double c = table[(2 * i + 1) * inv];
-      const double v0 = 1. * ys[         i];
-      const double v1 = c  * ys[nhalfs + i];
+      const solver_real_t c = table[(2 * i + 1) * inv];
+      const solver_real_t v0 = 1. * ys[         i];
+      const solver_real_t v1 = c  * ys[nhalfs + i];
       xs[             i] = v0 + v1;
       xs[nitems - 1 - i] = v0 - v1;
     }
   } else {
     // fallback to N^2 DCT3
     for (size_t j = 0; j < nitems; j++) {
-      double * y = ys + j;
+      solver_real_t * y = ys + j;
       *y = xs[0];
       for (size_t i = 1; i < nitems; i++) {
         const double phase = pi * (2. * j + 1.) * i / (2. * nitems);
@@ -149,31 +139,55 @@ static int dct3(
   return 0;
 }
 
+// one signal of dct_exec_f / dct_exec_b (see SPECIALISE)
+static void forward(
+    const size_t nitems,
+    const solver_real_t * const restrict table,
+    solver_real_t * const restrict xs,
+    solver_real_t * const restrict ys
+) {
+  dct2(nitems, 1, table, xs, ys);
+  for (size_t i = 0; i < nitems; i++) {
+    xs[i] *= 2.;
+  }
+}
+
+static void backward(
+    const size_t nitems,
+    const solver_real_t * const restrict table,
+    solver_real_t * const restrict xs,
+    solver_real_t * const restrict ys
+) {
+  xs[0] *= 0.5;
+  dct3(nitems, 1, table, xs, ys);
+  for (size_t i = 0; i < nitems; i++) {
+    xs[i] *= 2.;
+  }
+}
+
 // allocate, initalise, and pack
 int dct_init_plan(
     const size_t nitems,
     const size_t repeat_for,
     dct_plan_t ** const plan
 ) {
-  *plan = memory_alloc(1 * sizeof(dct_plan_t));
-  if (NULL == *plan) {
-    return 1;
-  }
+  *plan = memory_alloc(1, sizeof(dct_plan_t), MEMORY_TAG_SOLVER);
   (*plan)->nitems = nitems;
   (*plan)->repeat_for = repeat_for;
   // trigonometric table
-  double ** table = &(*plan)->table;
-  *table = memory_alloc(nitems * sizeof(double));
-  if (NULL == *table) {
-    return 1;
-  }
+  solver_real_t ** table = &(*plan)->table;
+  *table = memory_alloc(nitems, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
   for (size_t i = 0; i < nitems; i++) {
     const double phase = (pi * i) / (2. * nitems);
     (*table)[i] = 0.5 / cos(phase);
   }
   // internal buffer
-  double ** buf = &(*plan)->buf;
-  *buf = memory_alloc(nitems * repeat_for * sizeof(double));
+  solver_real_t ** buf = &(*plan)->buf;
+  // NOTE: one signal per thread, touched by the thread using it
+  const size_t nthreads = memory_nthreads();
+  (*plan)->nthreads = nthreads;
+  *buf = memory_alloc_aligned(nitems * nthreads, sizeof(solver_real_t), alignment, MEMORY_TAG_SOLVER);
+  memory_first_touch(*buf, nthreads, nitems * sizeof(solver_real_t));
   return 0;
 }
 
@@ -193,7 +207,7 @@ int dct_destroy_plan(
 
 int dct_exec_f(
     dct_plan_t * const plan,
-    double * restrict const xs
+    solver_real_t * restrict const xs
 ) {
   if (NULL == plan) {
     fprintf(stderr, "the plan is NULL\n");
@@ -201,21 +215,23 @@ int dct_exec_f(
   }
   const size_t nitems = plan->nitems;
   const size_t repeat_for = plan->repeat_for;
-  const double * const table = plan->table;
-  double * const ys = plan->buf;
-#pragma omp parallel for
+  const solver_real_t * const table = plan->table;
+  solver_real_t * const ys = plan->buf;
+  if (memory_in_parallel()) {
+    fprintf(stderr, "should not be called inside a parallel region\n");
+    return 1;
+  }
+  // NOTE: the team is limited to the threads for which the scratch is reserved
+#pragma omp parallel for num_threads((int)plan->nthreads)
   for (size_t j = 0; j < repeat_for; j++) {
-    dct2(nitems, 1, table, xs + j * nitems, ys + j * nitems);
-    for (size_t i = 0; i < nitems; i++) {
-      xs[j * nitems + i] *= 2.;
-    }
+    SPECIALISE(forward, nitems, table, xs + j * nitems, ys + memory_thread() * nitems);
   }
   return 0;
 }
 
 int dct_exec_b(
     dct_plan_t * const plan,
-    double * restrict const xs
+    solver_real_t * restrict const xs
 ) {
   if (NULL == plan) {
     fprintf(stderr, "the plan is NULL\n");
@@ -223,15 +239,16 @@ int dct_exec_b(
   }
   const size_t nitems = plan->nitems;
   const size_t repeat_for = plan->repeat_for;
-  const double * const table = plan->table;
-  double * const ys = plan->buf;
-#pragma omp parallel for
+  const solver_real_t * const table = plan->table;
+  solver_real_t * const ys = plan->buf;
+  if (memory_in_parallel()) {
+    fprintf(stderr, "should not be called inside a parallel region\n");
+    return 1;
+  }
+  // NOTE: the team is limited to the threads for which the scratch is reserved
+#pragma omp parallel for num_threads((int)plan->nthreads)
   for (size_t j = 0; j < repeat_for; j++) {
-    xs[j * nitems + 0] *= 0.5;
-    dct3(nitems, 1, table, xs + j * nitems, ys + j * nitems);
-    for (size_t i = 0; i < nitems; i++) {
-      xs[j * nitems + i] *= 2.;
-    }
+    SPECIALISE(backward, nitems, table, xs + j * nitems, ys + memory_thread() * nitems);
   }
   return 0;
 }
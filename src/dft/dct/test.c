@@ -65,8 +65,8 @@ static int test0(
     char objective[256] = {'\0'};
     sprintf(objective, "dct2 followed by dct3 should recover original result: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
@@ -103,8 +103,8 @@ static int test1(
     char objective[256] = {'\0'};
     sprintf(objective, "dct2 should yield same result as the naive one: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
@@ -140,8 +140,8 @@ static int test2(
     char objective[256] = {'\0'};
     sprintf(objective, "dct3 should yield same result as the naive one: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
@@ -1,9 +1,18 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <math.h>
-#include <complex.h>
+// NOTE: type-generic cos, sin, conj, creal, and cimag,
+//       which follow the precision of solver_real_t
+#include <tgmath.h>
+#include "memory.h"
+#include "specialise.h" // SPECIALISE
 #include "dft/rdft.h"
 
+#if defined(PRECISION_SINGLE) || defined(PRECISION_REFINED)
+typedef float complex solver_complex_t;
+#else
+typedef double complex solver_complex_t;
+#endif
+
 static const double pi = 3.14159265358979324;
 
 struct rdft_plan_t {
@@ -14,38 +23,26 @@ struct rdft_plan_t {
   // repeat DFTs for specified times
   size_t repeat_for;
   // pre-computed cosine / sine values
-  double * table_cos;
-  double * table_sin;
-  // internal buffer
-  double complex * buf;
+  solver_real_t * table_cos;
+  solver_real_t * table_sin;
+  // internal buffer, one signal per thread
+  solver_complex_t * buf;
+  // number of threads for which the buffer is reserved
+  size_t nthreads;
 };
 
-static void * memory_alloc(
-    const size_t size
-) {
-  void * const ptr = malloc(size);
-  if (NULL == ptr) {
-    fprintf(stderr, "[FATAL %s:%d] failed to allocate %zu bytes\n", __FILE__, __LINE__, size);
-    return NULL;
-  }
-  return ptr;
-}
-
-static void memory_free(
-    void * const ptr
-) {
-  free(ptr);
-}
+// cache line
+static const size_t alignment = 64;
 
 // recursive Cooley-Tukey FFT for complex input/output
 static int dft(
     const size_t nitems,
-    const double sign,
+    const solver_real_t sign,
     const size_t stride,
-    const double * const table_cos,
-    const double * const table_sin,
-    const double complex * xs,
-    double complex * ys
+    const solver_real_t * const table_cos,
+    const solver_real_t * const table_sin,
+    const solver_complex_t * xs,
+    solver_complex_t * ys
 ) {
   if (1 == nitems) {
     ys[0] = xs[0];
@@ -54,18 +51,18 @@ static int dft(
     dft(nitems / 2, sign, stride * 2, table_cos, table_sin, xs + stride, ys + nitems / 2);
     for (size_t i = 0; i < nitems / 2; i++) {
       const size_t j = i + nitems / 2;
-      const double c = table_cos[2 * stride * i];
-      const double s = table_sin[2 * stride * i];
-      const double complex twiddle = c + sign * I * s;
-      const double complex e = ys[i];
-      const double complex o = ys[j] * twiddle;
+      const solver_real_t c = table_cos[2 * stride * i];
+      const solver_real_t s = table_sin[2 * stride * i];
+      const solver_complex_t twiddle = c + sign * I * s;
+      const solver_complex_t e = ys[i];
+      const solver_complex_t o = ys[j] * twiddle;
       ys[i] = e + o;
       ys[j] = e - o;
     }
   } else {
     // naive O(N^2) DFT
     for (size_t k = 0; k < nitems; k++) {
-      double complex * y = ys + k;
+      solver_complex_t * y = ys + k;
       *y = 0. + I * 0.;
       for (size_t n = 0; n < nitems; n++) {
         *y += xs[stride * n] * cexp(sign * 2. * pi * n * k * I / nitems);
@@ -75,9 +72,69 @@ static int dft(
 	return 0;
 }
 
+// one signal of rdft_exec_f / rdft_exec_b (see SPECIALISE)
+static void forward(
+    const size_t nitems,
+    const solver_real_t * const table_cos,
+    const solver_real_t * const table_sin,
+    solver_real_t * const xs_j,
+    solver_complex_t * const zs_j
+) {
+  // create a signal composed of N/2 complex numbers
+  // x[2n] + I x[2n + 1] (n = 0, 1, ..., N / 2 - 1)
+  // NOTE: the original memory layout already satisfies the requirement
+  //       due to C99 standard, so we just cast and use it
+  dft(nitems / 2, - 1., 1, table_cos, table_sin, (solver_complex_t *)xs_j, zs_j);
+  // duplicate for later convenience
+  zs_j[nitems / 2] = zs_j[0];
+  // from the fourier transformed signal, compute FFT of even / odd signals
+  for (size_t i = 0; i < nitems / 2 + 1; i++) {
+    const solver_complex_t e = + 0.5 * zs_j[i] + 0.5 * conj(zs_j[nitems / 2 - i]);
+    const solver_complex_t o = - 0.5 * zs_j[i] + 0.5 * conj(zs_j[nitems / 2 - i]);
+    const solver_real_t c = table_cos[i];
+    const solver_real_t s = table_sin[i];
+    const solver_complex_t twiddle = c - I * s;
+    const solver_complex_t result = e + o * I * twiddle;
+    xs_j[i] = creal(result);
+    if (0 != i && nitems / 2 != i) {
+      xs_j[nitems - i] = cimag(result);
+    }
+  }
+}
+
+static void backward(
+    const size_t nitems,
+    const solver_real_t * const table_cos,
+    const solver_real_t * const table_sin,
+    solver_real_t * const xs_j,
+    solver_complex_t * const zs_j
+) {
+  for (size_t i = 0; i < nitems / 2; i++) {
+    const solver_real_t real0 =               xs_j[             i];
+    const solver_real_t imag0 = 0 == i ? 0. : xs_j[nitems     - i];
+    const solver_real_t real1 =               xs_j[nitems / 2 - i];
+    const solver_real_t imag1 = 0 == i ? 0. : xs_j[nitems / 2 + i];
+    const solver_complex_t val0 = real0 + I * imag0;
+    const solver_complex_t val1 = real1 + I * imag1;
+    const solver_complex_t e = + 0.5 * val0 + 0.5 * conj(val1);
+    const solver_complex_t o = + 0.5 * val0 - 0.5 * conj(val1);
+    const solver_real_t c = table_cos[i];
+    const solver_real_t s = table_sin[i];
+    const solver_complex_t twiddle = c + I * s;
+    zs_j[i] = e + o * I * twiddle;
+  }
+  dft(nitems / 2, + 1., 1, table_cos, table_sin, zs_j, (solver_complex_t *)xs_j);
+  // NOTE: performing DFTs whose size is nitems / 2
+  //       halves the amplitude of the resulting signal,
+  //       which is compensated here
+  for (size_t i = 0; i < nitems; i++) {
+    xs_j[i] *= 2.;
+  }
+}
+
 int rdft_exec_f(
     rdft_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 ) {
   if (NULL == plan) {
     puts("uninitialized plan is passed");
@@ -85,40 +142,26 @@ int rdft_exec_f(
   }
   const size_t nitems = plan->nitems;
   const size_t repeat_for = plan->repeat_for;
-  const double * const table_cos = plan->table_cos;
-  const double * const table_sin = plan->table_sin;
-  double complex * const zs = plan->buf;
-#pragma omp parallel for
+  const solver_real_t * const table_cos = plan->table_cos;
+  const solver_real_t * const table_sin = plan->table_sin;
+  solver_complex_t * const zs = plan->buf;
+  if (memory_in_parallel()) {
+    fprintf(stderr, "should not be called inside a parallel region\n");
+    return 1;
+  }
+  // NOTE: the team is limited to the threads for which the scratch is reserved
+#pragma omp parallel for num_threads((int)plan->nthreads)
   for (size_t j = 0; j < repeat_for; j++) {
-    double * xs_j = xs + j * nitems;
-    double complex * zs_j = zs + j * (nitems / 2 + 1);
-    // create a signal composed of N/2 complex numbers
-    // x[2n] + I x[2n + 1] (n = 0, 1, ..., N / 2 - 1)
-    // NOTE: the original memory layout already satisfies the requirement
-    //       due to C99 standard, so we just cast and use it
-    dft(nitems / 2, - 1., 1, table_cos, table_sin, (double complex *)xs_j, zs_j);
-    // duplicate for later convenience
-    zs_j[nitems / 2] = zs_j[0];
-    // from the fourier transformed signal, compute FFT of even / odd signals
-    for (size_t i = 0; i < nitems / 2 + 1; i++) {
-      const double complex e = + 0.5 * zs_j[i] + 0.5 * conj(zs_j[nitems / 2 - i]);
-      const double complex o = - 0.5 * zs_j[i] + 0.5 * conj(zs_j[nitems / 2 - i]);
-      const double c = table_cos[i];
-      const double s = table_sin[i];
-      const double complex twiddle = c - I * s;
-      const double complex result = e + o * I * twiddle;
-      xs_j[i] = creal(result);
-      if (0 != i && nitems / 2 != i) {
-        xs_j[nitems - i] = cimag(result);
-      }
-    }
+    solver_real_t * xs_j = xs + j * nitems;
+    solver_complex_t * zs_j = zs + memory_thread() * (nitems / 2 + 1);
+    SPECIALISE(forward, nitems, table_cos, table_sin, xs_j, zs_j);
   }
   return 0;
 }
 
 int rdft_exec_b(
     rdft_plan_t * const plan,
-    double * const xs
+    solver_real_t * const xs
 ) {
   if (NULL == plan) {
     puts("uninitialized plan is passed");
@@ -126,34 +169,19 @@ int rdft_exec_b(
   }
   const size_t nitems = plan->nitems;
   const size_t repeat_for = plan->repeat_for;
-  const double * const table_cos = plan->table_cos;
-  const double * const table_sin = plan->table_sin;
-  double complex * const zs = plan->buf;
-#pragma omp parallel for
+  const solver_real_t * const table_cos = plan->table_cos;
+  const solver_real_t * const table_sin = plan->table_sin;
+  solver_complex_t * const zs = plan->buf;
+  if (memory_in_parallel()) {
+    fprintf(stderr, "should not be called inside a parallel region\n");
+    return 1;
+  }
+  // NOTE: the team is limited to the threads for which the scratch is reserved
+#pragma omp parallel for num_threads((int)plan->nthreads)
   for (size_t j = 0; j < repeat_for; j++) {
-    double * xs_j = xs + j * nitems;
-    double complex * zs_j = zs + j * (nitems / 2 + 1);
-    for (size_t i = 0; i < nitems / 2; i++) {
-      const double real0 =               xs_j[             i];
-      const double imag0 = 0 == i ? 0. : xs_j[nitems     - i];
-      const double real1 =               xs_j[nitems / 2 - i];
-      const double imag1 = 0 == i ? 0. : xs_j[nitems / 2 + i];
-      const double complex val0 = real0 + I * imag0;
-      const double complex val1 = real1 + I * imag1;
-      const double complex e = + 0.5 * val0 + 0.5 * conj(val1);
-      const double complex o = + 0.5 * val0 - 0.5 * conj(val1);
-      const double c = table_cos[i];
-      const double s = table_sin[i];
-      const double complex twiddle = c + I * s;
-      zs_j[i] = e + o * I * twiddle;
-    }
-    dft(nitems / 2, + 1., 1, table_cos, table_sin, zs_j, (double complex *)xs_j);
-    // NOTE: performing DFTs whose size is nitems / 2
-    //       halves the amplitude of the resulting signal,
-    //       which is compensated here
-    for (size_t i = 0; i < nitems; i++) {
-      xs_j[i] *= 2.;
-    }
+    solver_real_t * xs_j = xs + j * nitems;
+    solver_complex_t * zs_j = zs + memory_thread() * (nitems / 2 + 1);
+    SPECIALISE(backward, nitems, table_cos, table_sin, xs_j, zs_j);
   }
   return 0;
 }
@@ -167,15 +195,19 @@ int rdft_init_plan(
     printf("signal length (%zu) should be a multiple of 2\n", nitems);
     return 1;
   }
-  *plan = memory_alloc(1 * sizeof(rdft_plan_t));
+  *plan = memory_alloc(1, sizeof(rdft_plan_t), MEMORY_TAG_SOLVER);
   (*plan)->nitems = nitems;
   (*plan)->repeat_for = repeat_for;
-  double ** table_cos = &(*plan)->table_cos;
-  double ** table_sin = &(*plan)->table_sin;
-  double complex ** buf = &(*plan)->buf;
-  *table_cos = memory_alloc((nitems / 2 + 1) * sizeof(double));
-  *table_sin = memory_alloc((nitems / 2 + 1) * sizeof(double));
-  *buf = memory_alloc((nitems / 2 + 1) * repeat_for * sizeof(double complex));
+  solver_real_t ** table_cos = &(*plan)->table_cos;
+  solver_real_t ** table_sin = &(*plan)->table_sin;
+  solver_complex_t ** buf = &(*plan)->buf;
+  *table_cos = memory_alloc(nitems / 2 + 1, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  *table_sin = memory_alloc(nitems / 2 + 1, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  // NOTE: one signal per thread, touched by the thread using it
+  const size_t nthreads = memory_nthreads();
+  (*plan)->nthreads = nthreads;
+  *buf = memory_alloc_aligned((nitems / 2 + 1) * nthreads, sizeof(solver_complex_t), alignment, MEMORY_TAG_SOLVER);
+  memory_first_touch(*buf, nthreads, (nitems / 2 + 1) * sizeof(solver_complex_t));
   // prepare cosine / sine tables
   for (size_t i = 0; i < nitems / 2 + 1; i++) {
     (*table_cos)[i] = cos(2. * pi * i / nitems);
@@ -87,8 +87,8 @@ static int test0(
     char objective[256] = {'\0'};
     snprintf(objective, sizeof(objective) - 1, "rdft followed by irdft should recover original result: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
@@ -125,8 +125,8 @@ static int test1(
     char objective[256] = {'\0'};
     snprintf(objective, sizeof(objective) - 1, "compare rdft with the naive one: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
@@ -162,8 +162,8 @@ static int test2(
     char objective[256] = {'\0'};
     snprintf(objective, sizeof(objective) - 1, "compare irdft with the naive one: nitems = %4zu", nitems);
     double * buffers[] = {
-      memory_alloc(nitems * repeat_for, sizeof(double)),
-      memory_alloc(nitems * repeat_for, sizeof(double)),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
+      memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER),
     };
     for (size_t j = 0; j < repeat_for; j++) {
       for (size_t i = 0; i < nitems; i++) {
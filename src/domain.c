@@ -1,23 +1,99 @@
+#include <math.h> // tanh
+#include "memory.h"
+#include "logger.h"
 #include "domain.h"
 
 const size_t ux_imin = X_PERIODIC ? 1 : 2;
 const size_t uy_jmin = Y_PERIODIC ? 1 : 2;
 
+// compute cell-face and cell-center positions in y and their distances,
+//   whose faces are clustered toward the walls with the hyperbolic tangent
+//   with the given "stretching" factor (zero: uniform spacing)
+int domain_init_y(
+    const double stretching,
+    domain_t * const domain
+) {
+  const double ly = domain->ly;
+  const size_t ny = domain->ny;
+  if (Y_PERIODIC && 0. != stretching) {
+    LOGGER_FAILURE("stretched grids are not supported for periodic directions");
+    goto abort;
+  }
+  double * const yf  = domain->yf  = memory_alloc(ny + 2, sizeof(double), MEMORY_TAG_OTHER);
+  double * const yc  = domain->yc  = memory_alloc(ny + 2, sizeof(double), MEMORY_TAG_OTHER);
+  double * const dyf = domain->dyf = memory_alloc(ny + 2, sizeof(double), MEMORY_TAG_OTHER);
+  double * const dyc = domain->dyc = memory_alloc(ny + 2, sizeof(double), MEMORY_TAG_OTHER);
+  if (0. == stretching) {
+    // NOTE: assigned directly to keep the spacings exactly identical
+    const double dy = ly / ny;
+    for (size_t j = 1; j <= ny + 1; j++) {
+      yf[j] = (j - 1) * dy;
+    }
+    for (size_t j = 1; j <= ny; j++) {
+      yc[j] = 0.5 * (2 * j - 1) * dy;
+    }
+    for (size_t j = 0; j <= ny + 1; j++) {
+      dyf[j] = dy;
+      dyc[j] = dy;
+    }
+  } else {
+    for (size_t j = 1; j <= ny + 1; j++) {
+      const double s = 2. * (j - 1) / ny - 1.;
+      yf[j] = 0.5 * ly * (1. + tanh(stretching * s) / tanh(stretching));
+    }
+    yf[     1] = 0.;
+    yf[ny + 1] = ly;
+    for (size_t j = 1; j <= ny; j++) {
+      yc[j] = 0.5 * (yf[j] + yf[j + 1]);
+      dyf[j] = yf[j + 1] - yf[j];
+    }
+    dyf[     0] = dyf[ 1];
+    dyf[ny + 1] = dyf[ny];
+  }
+  // mirror images of the boundary cells
+  yf[     0] = 2. * yf[     1] - yf[ 2];
+  yc[     0] = 2. * yf[     1] - yc[ 1];
+  yc[ny + 1] = 2. * yf[ny + 1] - yc[ny];
+  if (0. != stretching) {
+    for (size_t j = 1; j <= ny + 1; j++) {
+      dyc[j] = yc[j] - yc[j - 1];
+    }
+    dyc[0] = dyc[1];
+  }
+  return 0;
+abort:
+  return 1;
+}
+
 int domain_init(
     domain_t * const domain
 ) {
-  const double lx = 1.;
-  const double ly = 3.;
+  const double lx = DOMAIN_LX;
+  const double ly = DOMAIN_LY;
+#if defined(FIXED_NX) && defined(FIXED_NY)
+  const size_t nx = FIXED_NX;
+  const size_t ny = FIXED_NY;
+#else
   const size_t nx = 128;
   const size_t ny = 384;
+#endif
   const double dx = lx / nx;
-  const double dy = ly / ny;
+  // clustering of the cell faces toward the walls in y
+  const double stretching = 0.;
   domain->lx = lx;
   domain->ly = ly;
   domain->nx = nx;
   domain->ny = ny;
   domain->dx = dx;
-  domain->dy = dy;
-  return 0;
+  return domain_init_y(stretching, domain);
 }
 
+int domain_finalize(
+    domain_t * const domain
+) {
+  memory_free(domain->yf);
+  memory_free(domain->yc);
+  memory_free(domain->dyf);
+  memory_free(domain->dyc);
+  return 0;
+}
@@ -5,14 +5,14 @@
 
 int exchange_halo_x(
     const domain_t * const domain,
-    double ** const array
+    real_t ** const array
 ) {
   if (!X_PERIODIC) {
     LOGGER_FAILURE("x direction is not periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   for (size_t j = 0; j <= ny + 1; j++) {
     array[j][     0] = array[j][nx];
     array[j][nx + 1] = array[j][ 1];
@@ -24,14 +24,14 @@ abort:
 
 int exchange_halo_y(
     const domain_t * const domain,
-    double ** const array
+    real_t ** const array
 ) {
   if (!Y_PERIODIC) {
     LOGGER_FAILURE("y direction is not periodic");
     goto abort;
   }
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
   for (size_t i = 0; i <= nx + 1; i++) {
     array[     0][i] = array[ny][i];
     array[ny + 1][i] = array[ 1][i];
@@ -1,17 +1,21 @@
 #include <math.h>
 #include "logger.h"
+#include "memory.h"
+#include "param.h"
 #include "array.h"
 #include "domain.h"
 #include "flow_field.h"
 #include "boundary_condition.h"
 #include "exchange_halo.h"
+#include "./geometry.h"
 
 static int init_ux(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
+#pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
       ux[j][i] = 0.;
@@ -46,10 +50,11 @@ abort:
 
 static int init_uy(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
+#pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
       uy[j][i] = -1.;
@@ -84,10 +89,11 @@ abort:
 
 static int init_p(
     const domain_t * const domain,
-    double ** const p
+    real_t ** const p
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
+#pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
       p[j][i] = 0.;
@@ -110,24 +116,87 @@ abort:
   return 1;
 }
 
-static int init_weight(
+// signed-distance field of the bodies (see geometry.c),
+//   which replaces the analytical body below when given, e.g., "bodies.npy"
+static const char * const geometry_file_name = NULL;
+
+// parameters of the body
+//   amplitude (normalised by lx) and period of the oscillation (BODY_MOTION_OSCILLATING),
+//   density ratio to the fluid and gravitational acceleration (BODY_MOTION_FREE),
+//   where gravity is opposite to the incoming flow
+//   so that the body settles against it
+static const double oscillation_amplitude = 0.125;
+static const double oscillation_period = 2.;
+static const double density_ratio = 2.;
+static const double gravity[2] = {0., 7.};
+
+// tanh(x) is exactly unity in double precision for x larger than this,
+//   which limits the band of cells whose weights differ from zero or unity
+static const double saturation = 22.;
+
+static const double pi = 3.141592653589793;
+
+static int init_body(
     const domain_t * const domain,
-    double ** const weight
+    body_t * const body
 ) {
   const double lx = domain->lx;
   const double ly = domain->ly;
+  body->radius = lx / 16.;
+  body->origin[0] = 0.501 * lx;
+  body->origin[1] = 5. * ly / 6.;
+  body->center[0] = body->origin[0];
+  body->center[1] = body->origin[1];
+  body->velocity[0] = 0.;
+  body->velocity[1] = 0.;
+  return 0;
+}
+
+// find the cells around the body whose weights can differ from unity
+// NOTE: the body is assumed to stay away from the boundaries in x
+static cell_range_t find_band(
+    const domain_t * const domain,
+    const body_t * const body
+) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   const double dx = domain->dx;
-  const double dy = domain->dy;
-  const double center[2] = {
-    0.501 * lx,
-    5. * ly / 6.,
+  const double * const yc = domain->yc;
+  const double width = body->radius + saturation / ny;
+  const double xmin = (body->center[0] - width) / dx + 0.5;
+  const double xmax = (body->center[0] + width) / dx + 0.5;
+  const double ymin = body->center[1] - width;
+  const double ymax = body->center[1] + width;
+  cell_range_t band = {
+    .ilo = (size_t)fmin(fmax(floor(xmin), 0.), 1. * (nx + 1)),
+    .ihi = (size_t)fmin(fmax( ceil(xmax), 0.), 1. * (nx + 1)),
+    .jlo = 0,
+    .jhi = ny + 1,
   };
-  const double radius = lx / 16.;
-  for (size_t j = 0; j <= ny + 1; j++) {
-    const double y = 0.5 * (2 * j - 1) * dy;
-    for (size_t i = 0; i <= nx + 1; i++) {
+  while (band.jlo < ny + 1 && yc[band.jlo + 1] < ymin) {
+    band.jlo += 1;
+  }
+  while (0 < band.jhi && ymax < yc[band.jhi - 1]) {
+    band.jhi -= 1;
+  }
+  return band;
+}
+
+static int update_weight(
+    const domain_t * const domain,
+    const body_t * const body,
+    const cell_range_t * const range,
+    real_t ** const weight
+) {
+  const size_t ny = domain->ny;
+  const double dx = domain->dx;
+  const double * const yc = domain->yc;
+  const double * const center = body->center;
+  const double radius = body->radius;
+#pragma omp parallel for
+  for (size_t j = range->jlo; j <= range->jhi; j++) {
+    const double y = yc[j];
+    for (size_t i = range->ilo; i <= range->ihi; i++) {
       const double x = 0.5 * (2 * i - 1) * dx;
       const double d = sqrt(
           + pow(x - center[0], 2.)
@@ -139,16 +208,144 @@ static int init_weight(
   return 0;
 }
 
+// collect the velocity faces whose penalty factors,
+//   the averages of the weights of the two neighbouring cells
+//   ([j][i] and [j - dj][i - di]), differ from unity,
+//   where the cells outside "range" are assumed to have unit weights
+static int update_penalty(
+    const domain_t * const domain,
+    const size_t imin,
+    const size_t jmin,
+    const size_t di,
+    const size_t dj,
+    const cell_range_t * const range,
+    real_t ** const weight,
+    penalty_t * const penalty
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  const size_t ilo = imin < range->ilo ? range->ilo : imin;
+  const size_t jlo = jmin < range->jlo ? range->jlo : jmin;
+  const size_t ihi = range->ihi + di < nx ? range->ihi + di : nx;
+  const size_t jhi = range->jhi + dj < ny ? range->jhi + dj : ny;
+  for (size_t pass = 0; pass < 2; pass++) {
+    size_t nitems = 0;
+    for (size_t j = jlo; j <= jhi; j++) {
+      for (size_t i = ilo; i <= ihi; i++) {
+        const double factor = (
+            + 0.5 * weight[j - dj][i - di]
+            + 0.5 * weight[j     ][i     ]
+        );
+        // NOTE: faces whose factors are exactly one are not affected at all
+        if (1. == factor) {
+          continue;
+        }
+        if (1 == pass) {
+          penalty->faces[nitems] = (penalised_face_t){
+            .i = i,
+            .j = j,
+            .factor = factor,
+          };
+        }
+        nitems += 1;
+      }
+    }
+    // first pass: count (and extend the buffer when needed), second pass: assign
+    if (0 == pass) {
+      penalty->nitems = nitems;
+      if (penalty->capacity < nitems) {
+        memory_free(penalty->faces);
+        penalty->capacity = nitems;
+        penalty->faces = memory_alloc(nitems, sizeof(penalised_face_t), MEMORY_TAG_FIELD);
+      }
+    }
+  }
+  return 0;
+}
+
+// update the weights and the penalties after the body is moved,
+//   which are only recomputed inside the union of the old and new bands
+static int place_body(
+    const domain_t * const domain,
+    flow_field_t * const flow_field
+) {
+  body_t * const body = &flow_field->body;
+  const cell_range_t old = body->band;
+  const cell_range_t new = find_band(domain, body);
+  const cell_range_t range = {
+    .ilo = old.ilo < new.ilo ? old.ilo : new.ilo,
+    .ihi = old.ihi < new.ihi ? new.ihi : old.ihi,
+    .jlo = old.jlo < new.jlo ? old.jlo : new.jlo,
+    .jhi = old.jhi < new.jhi ? new.jhi : old.jhi,
+  };
+  update_weight(domain, body, &range, flow_field->weight);
+  update_penalty(domain, ux_imin,       1, 1, 0, &new, flow_field->weight, &flow_field->penalty_ux);
+  update_penalty(domain,       1, uy_jmin, 0, 1, &new, flow_field->weight, &flow_field->penalty_uy);
+  body->band = new;
+  return 0;
+}
+
+// advance the body from "time - dt" to "time"
+//   and update the weights and the penalties accordingly
+int flow_field_move_body(
+    const domain_t * const domain,
+    const double time,
+    const double dt,
+    flow_field_t * const flow_field
+) {
+  if (BODY_MOTION_FIXED == BODY_MOTION) {
+    return 0;
+  }
+  body_t * const body = &flow_field->body;
+  penalty_t * const penalties[2] = {
+    &flow_field->penalty_ux,
+    &flow_field->penalty_uy,
+  };
+  if (BODY_MOTION_OSCILLATING == BODY_MOTION) {
+    const double amplitude = oscillation_amplitude * domain->lx;
+    const double frequency = 2. * pi / oscillation_period;
+    body->center[0] = body->origin[0] + amplitude * sin(frequency * time);
+    body->velocity[0] = amplitude * frequency * cos(frequency * time);
+  } else {
+    // the force acting on the body is the opposite of the momentum
+    //   given to the fluid by the penalty per unit time,
+    //   where the fluid inside the body is assumed to move with the body
+    //   (Uhlmann, J. Comput. Phys., 2005)
+    const double volume = pi * pow(body->radius, 2.);
+    for (size_t dim = 0; dim < 2; dim++) {
+      const double force = - penalties[dim]->impulse / dt;
+      const double acceleration = gravity[dim] + force / (density_ratio - 1.) / volume;
+      body->velocity[dim] += dt * acceleration;
+      body->center[dim] += dt * body->velocity[dim];
+    }
+  }
+  for (size_t dim = 0; dim < 2; dim++) {
+    penalties[dim]->impulse = 0.;
+  }
+  return place_body(domain, flow_field);
+}
+
+// update the weights and the penalties
+//   after the position of the body is given externally (e.g., restart)
+int flow_field_place_body(
+    const domain_t * const domain,
+    flow_field_t * const flow_field
+) {
+  return place_body(domain, flow_field);
+}
+
 int flow_field_init(
     const domain_t * const domain,
     flow_field_t * const flow_field
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
-  array_init(nx + 2, ny + 2, &flow_field->ux);
-  array_init(nx + 2, ny + 2, &flow_field->uy);
-  array_init(nx + 2, ny + 2, &flow_field->p);
-  array_init(nx + 2, ny + 2, &flow_field->weight);
+  memory_arena_t ** const arena = &flow_field->arena;
+  *arena = memory_arena_init(4 * array_nbytes(nx + 2, ny + 2), MEMORY_TAG_FIELD);
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_field->ux);
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_field->uy);
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_field->p);
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_field->weight);
   if (0 != init_ux(domain, flow_field->ux)) {
     LOGGER_FAILURE("failed to initialize ux");
     goto abort;
@@ -161,9 +358,33 @@ int flow_field_init(
     LOGGER_FAILURE("failed to initialize p");
     goto abort;
   }
-  if (0 != init_weight(domain, flow_field->weight)) {
-    LOGGER_FAILURE("failed to initialize weight");
-    goto abort;
+  // the whole weight field is evaluated once,
+  //   while only the band around the body is updated afterwards
+  {
+    body_t * const body = &flow_field->body;
+    const cell_range_t range = {
+      .ilo = 0,
+      .ihi = nx + 1,
+      .jlo = 0,
+      .jhi = ny + 1,
+    };
+    init_body(domain, body);
+    if (NULL == geometry_file_name) {
+      update_weight(domain, body, &range, flow_field->weight);
+      body->band = find_band(domain, body);
+    } else {
+      if (BODY_MOTION_FIXED != BODY_MOTION) {
+        LOGGER_FAILURE("bodies given by a signed-distance field cannot move");
+        goto abort;
+      }
+      if (0 != geometry_init_weight(geometry_file_name, domain, flow_field->weight)) {
+        LOGGER_FAILURE("failed to initialize weight");
+        goto abort;
+      }
+      body->band = range;
+    }
+    update_penalty(domain, ux_imin,       1, 1, 0, &range, flow_field->weight, &flow_field->penalty_ux);
+    update_penalty(domain,       1, uy_jmin, 0, 1, &range, flow_field->weight, &flow_field->penalty_uy);
   }
   return 0;
 abort:
@@ -173,10 +394,9 @@ abort:
 int flow_field_finalize(
     flow_field_t * const flow_field
 ) {
-  array_finalize(&flow_field->ux);
-  array_finalize(&flow_field->uy);
-  array_finalize(&flow_field->p);
-  array_finalize(&flow_field->weight);
+  memory_arena_finalize(&flow_field->arena);
+  memory_free(flow_field->penalty_ux.faces);
+  memory_free(flow_field->penalty_uy.faces);
   return 0;
 }
 
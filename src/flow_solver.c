@@ -2,6 +2,7 @@
 #include "memory.h"
 #include "array.h"
 #include "logger.h"
+#include "param.h"
 #include "flow_solver.h"
 #include "dft/rdft.h"
 #include "dft/dct.h"
@@ -15,8 +16,8 @@ static int init_x_solver(
   const size_t ny = domain->ny;
   const double dx = domain->dx;
   double * const dft_norm = &poisson_solver->dft_norm;
-  double ** const wavenumbers = &poisson_solver->wavenumbers;
-  *wavenumbers = memory_alloc(nx, sizeof(double));
+  solver_real_t ** const wavenumbers = &poisson_solver->wavenumbers;
+  *wavenumbers = memory_alloc(nx, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
   if (X_PERIODIC) {
     rdft_plan_t ** const rdft_plan = &poisson_solver->rdft_plan;
     if (0 != rdft_init_plan(nx, ny, rdft_plan)) {
@@ -49,21 +50,24 @@ static int init_y_solver(
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
-  const double dy = domain->dy;
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
   tridiagonal_solver_plan_t ** const tridiagonal_solver_plan = &poisson_solver->tridiagonal_solver_plan;
   if (0 != tridiagonal_solver_init_plan(ny, nx, Y_PERIODIC, tridiagonal_solver_plan)) {
     LOGGER_FAILURE("failed to initialise tridiagonal_solver solver");
     goto abort;
   }
-  double ** const tridiagonal_solver_l = &poisson_solver->tridiagonal_solver_l;
-  double ** const tridiagonal_solver_c = &poisson_solver->tridiagonal_solver_c;
-  double ** const tridiagonal_solver_u = &poisson_solver->tridiagonal_solver_u;
-  *tridiagonal_solver_l = memory_alloc(ny, sizeof(double));
-  *tridiagonal_solver_c = memory_alloc(ny, sizeof(double));
-  *tridiagonal_solver_u = memory_alloc(ny, sizeof(double));
+  solver_real_t ** const tridiagonal_solver_l = &poisson_solver->tridiagonal_solver_l;
+  solver_real_t ** const tridiagonal_solver_c = &poisson_solver->tridiagonal_solver_c;
+  solver_real_t ** const tridiagonal_solver_u = &poisson_solver->tridiagonal_solver_u;
+  *tridiagonal_solver_l = memory_alloc(ny, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  *tridiagonal_solver_c = memory_alloc(ny, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  *tridiagonal_solver_u = memory_alloc(ny, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  // NOTE: the j-th row corresponds to the (j+1)-th cell center,
+  //       which is surrounded by the cell faces j+1 and j+2
   for (size_t j = 0; j < ny; j++) {
-    const double l = 1. / dy / dy;
-    const double u = 1. / dy / dy;
+    const double l = 1. / dyf[j + 1] / dyc[j + 1];
+    const double u = 1. / dyf[j + 1] / dyc[j + 2];
     (*tridiagonal_solver_l)[j] = + 1. * l;
     (*tridiagonal_solver_u)[j] = + 1. * u;
     (*tridiagonal_solver_c)[j] = - 1. * l
@@ -83,6 +87,99 @@ abort:
   return 1;
 }
 
+// discrete Laplacian for "nitems" unknowns repeated "repeat_for" times,
+//   whose boundary conditions are given by "lower" / "upper":
+//    0: Dirichlet (boundary values are not updated)
+//   +1: Neumann (halo value is mirrored)
+//   -1: Dirichlet on the cell face (halo value is anti-mirrored)
+// NOTE: "dc" is the width of the control volume of each unknown,
+//       while "dm" / "dp" are the distances to the neighbours
+static int init_diffusion_system(
+    const size_t nitems,
+    const size_t repeat_for,
+    const bool is_periodic,
+    const double * const dc,
+    const double * const dm,
+    const double * const dp,
+    const double lower,
+    const double upper,
+    diffusion_system_t * const diffusion_system
+) {
+  if (0 != tridiagonal_solver_init_plan(nitems, repeat_for, is_periodic, &diffusion_system->tridiagonal_solver_plan)) {
+    LOGGER_FAILURE("failed to initialise tridiagonal_solver solver");
+    goto abort;
+  }
+  solver_real_t * const l = diffusion_system->tridiagonal_solver_l = memory_alloc(nitems, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  solver_real_t * const c = diffusion_system->tridiagonal_solver_c = memory_alloc(nitems, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  solver_real_t * const u = diffusion_system->tridiagonal_solver_u = memory_alloc(nitems, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  diffusion_system->tridiagonal_solver_c_offsets = memory_alloc(repeat_for, sizeof(solver_real_t), MEMORY_TAG_SOLVER);
+  for (size_t n = 0; n < nitems; n++) {
+    l[n] = + 1. / dc[n] / dm[n];
+    u[n] = + 1. / dc[n] / dp[n];
+    c[n] = - l[n] - u[n];
+  }
+  if (!is_periodic) {
+    c[         0] += lower * l[         0];
+    c[nitems - 1] += upper * u[nitems - 1];
+  }
+  return 0;
+abort:
+  return 1;
+}
+
+static int finalize_diffusion_system(
+    diffusion_system_t * const diffusion_system
+) {
+  tridiagonal_solver_destroy_plan(&diffusion_system->tridiagonal_solver_plan);
+  memory_free(diffusion_system->tridiagonal_solver_l);
+  memory_free(diffusion_system->tridiagonal_solver_c);
+  memory_free(diffusion_system->tridiagonal_solver_u);
+  memory_free(diffusion_system->tridiagonal_solver_c_offsets);
+  return 0;
+}
+
+static int init_diffusion_solver(
+    const domain_t * const domain,
+    diffusion_solver_t * const diffusion_solver
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
+  // number of unknowns in each direction
+  const size_t ux_nx = nx + 1 - ux_imin;
+  const size_t uy_ny = ny + 1 - uy_jmin;
+  // grid spacings in x, which are uniform
+  double * const dx = memory_alloc(nx + 2, sizeof(double), MEMORY_TAG_SOLVER);
+  for (size_t i = 0; i < nx + 2; i++) {
+    dx[i] = domain->dx;
+  }
+  int error_code = 0;
+  // ux: impermeable walls in x,
+  //     dux/dy = 0 at the lower and ux = 0 at the upper boundaries
+  error_code += init_diffusion_system(ux_nx,    ny, X_PERIODIC, dx, dx, dx,  0.,  0., &diffusion_solver->ux_x);
+  error_code += init_diffusion_system(   ny, ux_nx, Y_PERIODIC, dyf + 1, dyc + 1, dyc + 2, +1., -1., &diffusion_solver->ux_y);
+  // uy: uy = 0 on the walls in x,
+  //     given velocities at the lower and upper boundaries
+  error_code += init_diffusion_system(   nx, uy_ny, X_PERIODIC, dx, dx, dx, -1., -1., &diffusion_solver->uy_x);
+  error_code += init_diffusion_system(uy_ny,    nx, Y_PERIODIC, dyc + uy_jmin, dyf + uy_jmin - 1, dyf + uy_jmin,  0.,  0., &diffusion_solver->uy_y);
+  memory_free(dx);
+  return error_code;
+}
+
+static bool is_uniform_y(
+    const domain_t * const domain
+) {
+  const size_t ny = domain->ny;
+  const double * const dyf = domain->dyf;
+  for (size_t j = 2; j <= ny; j++) {
+    if (dyf[1] != dyf[j]) {
+      return false;
+    }
+  }
+  return true;
+}
+
 int flow_solver_init(
     const domain_t * const domain,
     flow_solver_t * const flow_solver
@@ -90,15 +187,44 @@ int flow_solver_init(
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   // auxiliary buffers
-  array_init(nx + 2, ny + 2, &flow_solver->psi);
-  array_init(nx + 2, ny + 2, &flow_solver->dux);
-  array_init(nx + 2, ny + 2, &flow_solver->duy);
+  const size_t narrays = (LOW_MEMORY ? 2 : 3) + (TIME_MARCHING_AB2 == TIME_MARCHING ? 2 : 0);
+  const size_t nbufs = LOW_MEMORY ? 0 : 2;
+  memory_arena_t ** const arena = &flow_solver->arena;
+  *arena = memory_arena_init(
+      + narrays * array_nbytes(nx + 2, ny + 2)
+      + nbufs * (nx * ny * sizeof(solver_real_t) + 2 * ARRAY_ALIGNMENT),
+      MEMORY_TAG_SOLVER
+  );
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_solver->dux);
+  array_init_arena(*arena, nx + 2, ny + 2, &flow_solver->duy);
+  if (LOW_MEMORY) {
+    flow_solver->psi = flow_solver->duy;
+  } else {
+    array_init_arena(*arena, nx + 2, ny + 2, &flow_solver->psi);
+  }
+  // right-hand-side terms of the previous step
+  if (TIME_MARCHING_AB2 == TIME_MARCHING) {
+    history_t * const history = &flow_solver->history;
+    history->dt = 0.;
+    array_init_arena(*arena, nx + 2, ny + 2, &history->dux);
+    array_init_arena(*arena, nx + 2, ny + 2, &history->duy);
+  }
   // poisson solver
   poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
-  double ** const buf0 = &poisson_solver->buf0;
-  double ** const buf1 = &poisson_solver->buf1;
-  *buf0 = memory_alloc(nx * ny, sizeof(double));
-  *buf1 = memory_alloc(nx * ny, sizeof(double));
+  solver_real_t ** const buf0 = &poisson_solver->buf0;
+  solver_real_t ** const buf1 = &poisson_solver->buf1;
+  // NOTE: pages are placed following the threads using them,
+  //       i.e., x-aligned (ny pencils) for buf0 and y-aligned (nx pencils) for buf1
+  if (LOW_MEMORY) {
+    // NOTE: the arrays have at least nx * ny elements
+    *buf0 = (void *)array_view(flow_solver->dux).data;
+    *buf1 = (void *)array_view(flow_solver->duy).data;
+  } else {
+    *buf0 = memory_arena_alloc(*arena, nx * ny, sizeof(solver_real_t), ARRAY_ALIGNMENT);
+    *buf1 = memory_arena_alloc(*arena, nx * ny, sizeof(solver_real_t), ARRAY_ALIGNMENT);
+    memory_first_touch(*buf0, ny, nx * sizeof(solver_real_t));
+    memory_first_touch(*buf1, nx, ny * sizeof(solver_real_t));
+  }
   // x direction: dft-related things
   if (0 != init_x_solver(domain, poisson_solver)) {
     LOGGER_FAILURE("failed to initialise dft part of poisson solver");
@@ -109,6 +235,39 @@ int flow_solver_init(
     LOGGER_FAILURE("failed to initialise tridiagonal_solver part of poisson solver");
     goto abort;
   }
+  // implicit treatment of diffusive terms
+  // NOTE: the register of the low-storage Runge-Kutta scheme
+  //       cannot be shared with the implicit increments
+  // NOTE: the semi-Lagrangian scheme gives the change over a step directly,
+  //       which is not a right-hand-side term of multi-stage / multi-step schemes
+  if (SEMI_LAGRANGIAN_ADVECTION && !is_uniform_y(domain)) {
+    LOGGER_FAILURE("semi-Lagrangian advection is only supported on uniform grids");
+    goto abort;
+  }
+  if (SEMI_LAGRANGIAN_ADVECTION && TIME_MARCHING_EULER != TIME_MARCHING) {
+    LOGGER_FAILURE("semi-Lagrangian advection is only supported by TIME_MARCHING_EULER");
+    goto abort;
+  }
+  if (LOW_MEMORY && (IMPLICIT_DIFFUSION || SEMI_LAGRANGIAN_ADVECTION || TIME_MARCHING_RK3 == TIME_MARCHING)) {
+    LOGGER_FAILURE("LOW_MEMORY is not supported by IMPLICIT_DIFFUSION, SEMI_LAGRANGIAN_ADVECTION, or TIME_MARCHING_RK3");
+    goto abort;
+  }
+  // NOTE: the buffers of the poisson solver are shared with the increments,
+  //       which should have the same element size
+  if (LOW_MEMORY && sizeof(solver_real_t) != sizeof(real_t)) {
+    LOGGER_FAILURE("LOW_MEMORY is not supported by PRECISION=mixed or refined");
+    goto abort;
+  }
+  if (IMPLICIT_DIFFUSION && TIME_MARCHING_RK3 == TIME_MARCHING) {
+    LOGGER_FAILURE("implicit diffusion is not supported by TIME_MARCHING_RK3");
+    goto abort;
+  }
+  if (IMPLICIT_DIFFUSION) {
+    if (0 != init_diffusion_solver(domain, &flow_solver->diffusion_solver)) {
+      LOGGER_FAILURE("failed to initialise diffusion solver");
+      goto abort;
+    }
+  }
   return 0;
 abort:
   LOGGER_FAILURE("failed to initialise flow solver");
@@ -118,14 +277,10 @@ abort:
 int flow_solver_finalize(
     flow_solver_t * const flow_solver
 ) {
-  // auxiliary buffers
-  array_finalize(&flow_solver->psi);
-  array_finalize(&flow_solver->dux);
-  array_finalize(&flow_solver->duy);
+  // auxiliary buffers and the buffers of the poisson solver
+  memory_arena_finalize(&flow_solver->arena);
   // poisson solver
   poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
-  memory_free(poisson_solver->buf0);
-  memory_free(poisson_solver->buf1);
   if (X_PERIODIC) {
     rdft_destroy_plan(&poisson_solver->rdft_plan);
   } else {
@@ -136,6 +291,14 @@ int flow_solver_finalize(
   memory_free(poisson_solver->tridiagonal_solver_l);
   memory_free(poisson_solver->tridiagonal_solver_c);
   memory_free(poisson_solver->tridiagonal_solver_u);
+  // implicit treatment of diffusive terms
+  if (IMPLICIT_DIFFUSION) {
+    diffusion_solver_t * const diffusion_solver = &flow_solver->diffusion_solver;
+    finalize_diffusion_system(&diffusion_solver->ux_x);
+    finalize_diffusion_system(&diffusion_solver->ux_y);
+    finalize_diffusion_system(&diffusion_solver->uy_x);
+    finalize_diffusion_system(&diffusion_solver->uy_y);
+  }
   return 0;
 }
 
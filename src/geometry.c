@@ -0,0 +1,299 @@
+// stat
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // FILE, fopen, fclose, fread, fwrite, snprintf
+#include <stdlib.h> // free
+#include <stdint.h> // uint64_t
+#include <stdbool.h> // bool, false
+#include <string.h> // strlen, strcmp
+#include <inttypes.h> // PRIx64
+#include <errno.h> // errno
+#include <math.h> // tanh
+#include <sys/stat.h> // stat
+#include "memory.h"
+#include "logger.h"
+#include "real.h"
+#include "domain.h"
+#include "./geometry.h"
+#include "./save/snpyio.h"
+
+// bodies are given by a signed-distance field (negative inside the bodies),
+//   which is a two-dimensional NPY file (float64, row-major) of shape (my, mx)
+//   whose [m][l] element is located at x = lx * l / (mx - 1), y = ly * m / (my - 1)
+// the resulting weights are cached next to the input file (always in float64),
+//   whose name contains a hash of the grid and the input file,
+//   so that the following runs with the same grid skip the preprocessing
+
+#define NDIMS 2
+
+// increment when the conversion from the distance to the weight is changed
+static const uint64_t version = 1;
+
+// FNV-1a hash
+static uint64_t hash(
+    uint64_t value,
+    const void * const data,
+    const size_t size
+) {
+  const unsigned char * const bytes = data;
+  for (size_t n = 0; n < size; n++) {
+    value ^= bytes[n];
+    value *= UINT64_C(0x100000001b3);
+  }
+  return value;
+}
+
+// identify the grid and the input file (by its size and modification time)
+static uint64_t find_key(
+    const domain_t * const domain,
+    const struct stat * const file_stat
+) {
+  const int64_t file_size = (int64_t)file_stat->st_size;
+  const int64_t file_time = (int64_t)file_stat->st_mtime;
+  uint64_t key = UINT64_C(0xcbf29ce484222325);
+  key = hash(key, &version, sizeof(version));
+  key = hash(key, &domain->lx, sizeof(double));
+  key = hash(key, &domain->ly, sizeof(double));
+  key = hash(key, &domain->nx, sizeof(size_t));
+  key = hash(key, &domain->ny, sizeof(size_t));
+  key = hash(key, &domain->dx, sizeof(double));
+  key = hash(key, domain->yc, (domain->ny + 2) * sizeof(double));
+  key = hash(key, &file_size, sizeof(int64_t));
+  key = hash(key, &file_time, sizeof(int64_t));
+  return key;
+}
+
+// read a two-dimensional float64 NPY file, whose shape is returned
+static int read_npy_file(
+    const char file_name[],
+    size_t shape[NDIMS],
+    double ** const data
+) {
+  int error_code = 0;
+  FILE * fp = NULL;
+  size_t ndims = 0;
+  size_t * shape_ = NULL;
+  char * dtype = NULL;
+  bool is_fortran_order = false;
+  size_t header_size = 0;
+  errno = 0;
+  fp = fopen(file_name, "r");
+  if (NULL == fp) {
+    perror(file_name);
+    error_code = 1;
+    goto abort;
+  }
+  if (0 != snpyio_r_header(&ndims, &shape_, &dtype, &is_fortran_order, fp, &header_size)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to read NPY header");
+    goto abort;
+  }
+  if (NDIMS != ndims || 0 != strcmp("'<f8'", dtype) || is_fortran_order) {
+    fprintf(stderr, "%s: unexpected data set (%s, %zu dimension(s))\n", file_name, dtype, ndims);
+    error_code = 1;
+    LOGGER_FAILURE("two-dimensional float64 data set in row-major order is expected");
+    goto abort;
+  }
+  shape[0] = shape_[0];
+  shape[1] = shape_[1];
+  *data = memory_alloc(shape[0] * shape[1], sizeof(double), MEMORY_TAG_IO);
+  if (shape[0] * shape[1] != fread(*data, sizeof(double), shape[0] * shape[1], fp)) {
+    memory_free(*data);
+    *data = NULL;
+    error_code = 1;
+    LOGGER_FAILURE("file is smaller than expected");
+    goto abort;
+  }
+abort:
+  // NOTE: allocated by snpyio_r_header
+  free(shape_);
+  free(dtype);
+  if (NULL != fp) {
+    fclose(fp);
+  }
+  return error_code;
+}
+
+static int write_npy_file(
+    const char file_name[],
+    const size_t shape[NDIMS],
+    real_t ** const array
+) {
+  int error_code = 0;
+  FILE * fp = NULL;
+  size_t header_size = 0;
+  double * row = memory_alloc(shape[1], sizeof(double), MEMORY_TAG_IO);
+  errno = 0;
+  fp = fopen(file_name, "w");
+  if (NULL == fp) {
+    perror(file_name);
+    error_code = 1;
+    goto abort;
+  }
+  if (0 != snpyio_w_header(NDIMS, shape, "'<f8'", false, fp, &header_size)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to write NPY header");
+    goto abort;
+  }
+  for (size_t j = 0; j < shape[0]; j++) {
+    for (size_t i = 0; i < shape[1]; i++) {
+      row[i] = array[j][i];
+    }
+    if (shape[1] != fwrite(row, sizeof(double), shape[1], fp)) {
+      error_code = 1;
+      LOGGER_FAILURE("failed to write data");
+      goto abort;
+    }
+  }
+abort:
+  memory_free(row);
+  if (NULL != fp) {
+    fclose(fp);
+  }
+  return error_code;
+}
+
+// bilinear interpolation of the signed-distance field,
+//   where positions outside the field are clamped
+static double interpolate(
+    const domain_t * const domain,
+    const size_t shape[NDIMS],
+    const double * const sdf,
+    const double x,
+    const double y
+) {
+  const double positions[NDIMS] = {
+    y / domain->ly * (shape[0] - 1),
+    x / domain->lx * (shape[1] - 1),
+  };
+  size_t indices[NDIMS] = {0};
+  double weights[NDIMS] = {0.};
+  for (size_t dim = 0; dim < NDIMS; dim++) {
+    const double s = fmin(fmax(positions[dim], 0.), shape[dim] - 1.);
+    const size_t n = (size_t)s;
+    indices[dim] = n < shape[dim] - 1 ? n : shape[dim] - 2;
+    weights[dim] = s - indices[dim];
+  }
+  const size_t m = indices[0];
+  const size_t l = indices[1];
+  const double wy = weights[0];
+  const double wx = weights[1];
+  const size_t mx = shape[1];
+  return
+    + (1. - wy) * (1. - wx) * sdf[(m    ) * mx + (l    )]
+    + (1. - wy) * (     wx) * sdf[(m    ) * mx + (l + 1)]
+    + (     wy) * (1. - wx) * sdf[(m + 1) * mx + (l    )]
+    + (     wy) * (     wx) * sdf[(m + 1) * mx + (l + 1)];
+}
+
+static int convert(
+    const char file_name[],
+    const domain_t * const domain,
+    real_t ** const weight
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  const double dx = domain->dx;
+  const double * const yc = domain->yc;
+  size_t shape[NDIMS] = {0};
+  double * sdf = NULL;
+  if (0 != read_npy_file(file_name, shape, &sdf)) {
+    LOGGER_FAILURE("failed to read signed-distance field");
+    goto abort;
+  }
+  if (shape[0] < 2 || shape[1] < 2) {
+    LOGGER_FAILURE("signed-distance field should have at least two points in each direction");
+    goto abort;
+  }
+  // same sharpness as the analytical body (see flow_field.c)
+#pragma omp parallel for
+  for (size_t j = 0; j <= ny + 1; j++) {
+    const double y = yc[j];
+    for (size_t i = 0; i <= nx + 1; i++) {
+      const double x = (i - 0.5) * dx;
+      const double d = interpolate(domain, shape, sdf, x, y);
+      weight[j][i] = 0.5 * (1. + tanh(ny * d));
+    }
+  }
+  memory_free(sdf);
+  return 0;
+abort:
+  memory_free(sdf);
+  return 1;
+}
+
+static int load_cache(
+    const char cache_name[],
+    const domain_t * const domain,
+    real_t ** const weight
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  struct stat cache_stat = {0};
+  if (0 != stat(cache_name, &cache_stat)) {
+    return 1;
+  }
+  size_t shape[NDIMS] = {0};
+  double * data = NULL;
+  if (0 != read_npy_file(cache_name, shape, &data)) {
+    return 1;
+  }
+  if (ny + 2 != shape[0] || nx + 2 != shape[1]) {
+    memory_free(data);
+    return 1;
+  }
+  for (size_t j = 0; j < shape[0]; j++) {
+    for (size_t i = 0; i < shape[1]; i++) {
+      weight[j][i] = data[j * shape[1] + i];
+    }
+  }
+  memory_free(data);
+  return 0;
+}
+
+// assign the weights of the bodies given by the signed-distance field "file_name",
+//   using the cache when available
+int geometry_init_weight(
+    const char file_name[],
+    const domain_t * const domain,
+    real_t ** const weight
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  char * cache_name = NULL;
+  errno = 0;
+  struct stat file_stat = {0};
+  if (0 != stat(file_name, &file_stat)) {
+    perror(file_name);
+    LOGGER_FAILURE("failed to find signed-distance field");
+    goto abort;
+  }
+  // <file_name>.weight.<key>.npy
+  {
+    const uint64_t key = find_key(domain, &file_stat);
+    const int nchars = snprintf(NULL, 0, "%s.weight.%016" PRIx64 ".npy", file_name, key) + 1;
+    cache_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
+    if (nchars - 1 != snprintf(cache_name, nchars, "%s.weight.%016" PRIx64 ".npy", file_name, key)) {
+      LOGGER_FAILURE("snprintf returns unexpected result");
+      goto abort;
+    }
+  }
+  if (0 == load_cache(cache_name, domain, weight)) {
+    printf("geometry is loaded from %s\n", cache_name);
+  } else {
+    if (0 != convert(file_name, domain, weight)) {
+      goto abort;
+    }
+    // NOTE: the simulation continues even if the cache is not written
+    const size_t shape[NDIMS] = {ny + 2, nx + 2};
+    if (0 != write_npy_file(cache_name, shape, weight)) {
+      LOGGER_FAILURE("failed to write geometry cache");
+    }
+  }
+  memory_free(cache_name);
+  return 0;
+abort:
+  memory_free(cache_name);
+  LOGGER_FAILURE("failed to initialise geometry");
+  return 1;
+}
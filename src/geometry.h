@@ -0,0 +1,13 @@
+#if !defined(GEOMETRY_H)
+#define GEOMETRY_H
+
+#include "domain.h" // domain_t
+#include "real.h" // real_t
+
+extern int geometry_init_weight(
+    const char file_name[],
+    const domain_t * const domain,
+    real_t ** const weight
+);
+
+#endif // GEOMETRY_H
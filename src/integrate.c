@@ -1,4 +1,9 @@
+// clock_gettime, CLOCK_MONOTONIC
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h> // clock_gettime
 #include "logger.h"
+#include "param.h"
 #include "./integrate.h"
 #include "./integrate/decide_dt.h"
 #include "./integrate/predict.h"
@@ -6,31 +11,100 @@
 #include "./integrate/correct.h"
 #include "./integrate/update_pressure.h"
 
+// coefficients of the time-marching schemes,
+//   each stage consists of the prediction and the projection:
+//     du <- alpha * du + dt * (right-hand-side terms)
+//     u  <- u + beta * du
+//   followed by the projection using "beta * dt"
+#define NSTAGES_MAX 3
+static const struct {
+  size_t nstages;
+  double alpha[NSTAGES_MAX];
+  double beta[NSTAGES_MAX];
+} schemes[] = {
+  [TIME_MARCHING_EULER] = {
+    .nstages = 1,
+    .alpha = {0.},
+    .beta  = {1.},
+  },
+  [TIME_MARCHING_RK3] = {
+    .nstages = 3,
+    .alpha = {0.,      -5. /   9., -153. / 128.},
+    .beta  = {1. / 3., 15. /  16.,    8. /  15.},
+  },
+  // NOTE: extrapolation is handled in predict
+  [TIME_MARCHING_AB2] = {
+    .nstages = 1,
+    .alpha = {0.},
+    .beta  = {1.},
+  },
+};
+
+static double get_time(
+    void
+) {
+  struct timespec ts = {0};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1.e-9 * ts.tv_nsec;
+}
+
 int integrate(
     const domain_t * const domain,
     flow_field_t * const flow_field,
     flow_solver_t * const flow_solver,
-    double * const dt
+    double * const dt,
+    integrate_timings_t * const timings
 ) {
+  double tic = get_time();
+  double toc = tic;
   if (0 != decide_dt(domain, flow_field, dt)) {
     LOGGER_FAILURE("failed to find time-step size");
     goto abort;
   }
-  if (0 != predict(domain, flow_field, flow_solver, *dt)) {
-    LOGGER_FAILURE("failed to predict flow field");
-    goto abort;
-  }
-  if (0 != solve_poisson(domain, flow_field, flow_solver, *dt)) {
-    LOGGER_FAILURE("failed to solve Poisson equation to find scalar potential");
-    goto abort;
-  }
-  if (0 != correct(domain, flow_field, flow_solver, *dt)) {
-    LOGGER_FAILURE("failed to enforce incompressibility");
-    goto abort;
-  }
-  if (0 != update_pressure(domain, flow_field, flow_solver)) {
-    LOGGER_FAILURE("failed to update pressure field");
-    goto abort;
+  toc = get_time();
+  timings->decide_dt = toc - tic;
+  timings->predict = 0.;
+  timings->solve_poisson = 0.;
+  timings->correct = 0.;
+  timings->update_pressure = 0.;
+  for (size_t stage = 0; stage < schemes[TIME_MARCHING].nstages; stage++) {
+    const double alpha = schemes[TIME_MARCHING].alpha[stage];
+    const double beta  = schemes[TIME_MARCHING].beta[stage];
+    tic = get_time();
+    if (0 != predict(domain, flow_field, flow_solver, *dt, alpha, beta)) {
+      LOGGER_FAILURE("failed to predict flow field");
+      goto abort;
+    }
+    toc = get_time();
+    timings->predict += toc - tic;
+    tic = toc;
+    if (0 != solve_poisson(domain, flow_field, flow_solver, beta * *dt)) {
+      LOGGER_FAILURE("failed to solve Poisson equation to find scalar potential");
+      goto abort;
+    }
+    toc = get_time();
+    timings->solve_poisson += toc - tic;
+    tic = toc;
+    if (0 != correct(domain, flow_field, flow_solver, beta * *dt)) {
+      LOGGER_FAILURE("failed to enforce incompressibility");
+      goto abort;
+    }
+    // the register is used by the following stage
+    if (stage + 1 < schemes[TIME_MARCHING].nstages) {
+      if (0 != correct_increments(domain, flow_solver, *dt)) {
+        LOGGER_FAILURE("failed to project increments");
+        goto abort;
+      }
+    }
+    toc = get_time();
+    timings->correct += toc - tic;
+    tic = toc;
+    if (0 != update_pressure(domain, flow_field, flow_solver)) {
+      LOGGER_FAILURE("failed to update pressure field");
+      goto abort;
+    }
+    toc = get_time();
+    timings->update_pressure += toc - tic;
   }
   return 0;
 abort:
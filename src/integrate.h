@@ -5,11 +5,21 @@
 #include "flow_field.h" // flow_field_t
 #include "flow_solver.h" // flow_solver_t
 
+// wall-clock time (in seconds) spent in each stage of the latest step
+typedef struct {
+  double decide_dt;
+  double predict;
+  double solve_poisson;
+  double correct;
+  double update_pressure;
+} integrate_timings_t;
+
 extern int integrate(
     const domain_t * const domain,
     flow_field_t * const flow_field,
     flow_solver_t * const flow_solver,
-    double * const dt
+    double * const dt,
+    integrate_timings_t * const timings
 );
 
 #endif // INTEGRATE_H
@@ -1,36 +1,78 @@
 #include "logger.h"
+#include "array.h"
 #include "exchange_halo.h"
+#include "simd.h"
 #include "./correct.h"
 
-static int correct_ux(
+// u <- u - dt * dpsi/dx
+SIMD_DISPATCH
+static int subtract_gradient_x(
     const domain_t * const domain,
-    flow_field_t * const flow_field,
-    const flow_solver_t * const flow_solver,
-    const double dt
+    const double dt,
+    const array_view_t psi_view,
+    const array_view_t u_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
-  double * const * const psi = flow_solver->psi;
-  double ** const ux = flow_field->ux;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double dx = DOMAIN_DX(domain);
+  const size_t pitch = u_view.pitch;
+  const real_t * restrict const psi = ARRAY_ASSUME_ALIGNED(psi_view.data);
+  real_t * restrict const u = ARRAY_ASSUME_ALIGNED(u_view.data);
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = ux_imin; i <= nx; i++) {
-      ux[j][i] -= dt / dx * (
-          - psi[j    ][i - 1]
-          + psi[j    ][i    ]
+      u[j * pitch + i] -= dt / dx * (
+          - psi[(j    ) * pitch + (i - 1)]
+          + psi[(j    ) * pitch + (i    )]
       );
     }
   }
+  return 0;
+}
+
+// u <- u - dt * dpsi/dy
+SIMD_DISPATCH
+static int subtract_gradient_y(
+    const domain_t * const domain,
+    const double dt,
+    const array_view_t psi_view,
+    const array_view_t u_view
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double * const dyc = domain->dyc;
+  const size_t pitch = u_view.pitch;
+  const real_t * restrict const psi = ARRAY_ASSUME_ALIGNED(psi_view.data);
+  real_t * restrict const u = ARRAY_ASSUME_ALIGNED(u_view.data);
+#pragma omp parallel for
+  for (size_t j = uy_jmin; j <= ny; j++) {
+    const double dy = dyc[j];
+    for (size_t i = 1; i <= nx; i++) {
+      u[j * pitch + i] -= dt / dy * (
+          - psi[(j - 1) * pitch + (i    )]
+          + psi[(j    ) * pitch + (i    )]
+      );
+    }
+  }
+  return 0;
+}
+
+static int correct_ux(
+    const domain_t * const domain,
+    flow_field_t * const flow_field,
+    const flow_solver_t * const flow_solver,
+    const double dt
+) {
+  subtract_gradient_x(domain, dt, array_view(flow_solver->psi), array_view(flow_field->ux));
   // NOTE: since the scalar pressure does not modify velocities on the boundaries,
   //       only halo exchanges are done here (not imposing BCs again)
   if (X_PERIODIC) {
-    if (0 != exchange_halo_x(domain, ux)) {
+    if (0 != exchange_halo_x(domain, flow_field->ux)) {
       goto abort;
     }
   }
   if (Y_PERIODIC) {
-    if (0 != exchange_halo_y(domain, ux)) {
+    if (0 != exchange_halo_y(domain, flow_field->ux)) {
       goto abort;
     }
   }
@@ -45,29 +87,16 @@ static int correct_uy(
     const flow_solver_t * const flow_solver,
     const double dt
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dy = domain->dy;
-  double * const * const psi = flow_solver->psi;
-  double ** const uy = flow_field->uy;
-#pragma omp parallel for
-  for (size_t j = uy_jmin; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      uy[j][i] -= dt / dy * (
-          - psi[j - 1][i    ]
-          + psi[j    ][i    ]
-      );
-    }
-  }
+  subtract_gradient_y(domain, dt, array_view(flow_solver->psi), array_view(flow_field->uy));
   // NOTE: since the scalar pressure does not modify velocities on the boundaries,
   //       only halo exchanges are done here (not imposing BCs again)
   if (X_PERIODIC) {
-    if (0 != exchange_halo_x(domain, uy)) {
+    if (0 != exchange_halo_x(domain, flow_field->uy)) {
       goto abort;
     }
   }
   if (Y_PERIODIC) {
-    if (0 != exchange_halo_y(domain, uy)) {
+    if (0 != exchange_halo_y(domain, flow_field->uy)) {
       goto abort;
     }
   }
@@ -76,6 +105,21 @@ abort:
   return 1;
 }
 
+// project the increments as well,
+//   which are carried to the next stage as the register
+//   of the low-storage Runge-Kutta scheme
+// NOTE: "dt" is the time-step size without the stage coefficient,
+//       since the increments are multiplied by it when the velocity is updated
+int correct_increments(
+    const domain_t * const domain,
+    const flow_solver_t * const flow_solver,
+    const double dt
+) {
+  subtract_gradient_x(domain, dt, array_view(flow_solver->psi), array_view(flow_solver->dux));
+  subtract_gradient_y(domain, dt, array_view(flow_solver->psi), array_view(flow_solver->duy));
+  return 0;
+}
+
 int correct(
     const domain_t * const domain,
     flow_field_t * const flow_field,
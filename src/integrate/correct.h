@@ -12,4 +12,10 @@ extern int correct(
     const double dt
 );
 
+extern int correct_increments(
+    const domain_t * const domain,
+    const flow_solver_t * const flow_solver,
+    const double dt
+);
+
 #endif // CORRECT_H
@@ -6,28 +6,41 @@
 
 static const size_t ndims = 2;
 
+// NOTE: the limits reflect the stability regions of the schemes;
+//       RK3 covers a wider part of both axes than Euler forward,
+//       while AB2 is half as stable for diffusion
+//       but takes only one right-hand-side evaluation per step
+// NOTE: the Courant number is limited in each direction separately,
+//       while the advective limit of RK3 (sqrt(3)) applies to their sum,
+//       which reaches twice the per-direction value in diagonal flows
 static const struct {
   // Courant number
   double adv;
   // Faraday number
   double dif;
-} safety_factors = {
-  .adv = 0.25,
-  .dif = 0.95,
+} safety_factors[] = {
+  [TIME_MARCHING_EULER] = {.adv = 0.25, .dif = 0.95},
+  [TIME_MARCHING_RK3]   = {.adv = 0.85, .dif = 1.15},
+  [TIME_MARCHING_AB2]   = {.adv = 0.50, .dif = 0.45},
 };
 
+// Courant number for the semi-Lagrangian scheme,
+//   which is limited by accuracy rather than stability:
+//   larger values remain bounded but smear the wake of the object
+static const double semi_lagrangian_courant = 1.;
+
 static int decide_dt_adv(
     const domain_t * const domain,
     const flow_field_t * const flow_field,
     double * const dt
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
-  const double dy = domain->dy;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double dx = DOMAIN_DX(domain);
+  const double * const dyc = domain->dyc;
   const double small = 1.e-8;
-  double ** const ux = flow_field->ux;
-  double ** const uy = flow_field->uy;
+  real_t ** const ux = flow_field->ux;
+  real_t ** const uy = flow_field->uy;
   *dt = 1.;
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = ux_imin; i <= nx; i++) {
@@ -38,10 +51,10 @@ static int decide_dt_adv(
   for (size_t j = uy_jmin; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
       const double denominator = fmax(small, fabs(uy[j][i]));
-      *dt = fmin(*dt, dy / denominator);
+      *dt = fmin(*dt, dyc[j] / denominator);
     }
   }
-  *dt *= safety_factors.adv;
+  *dt *= SEMI_LAGRANGIAN_ADVECTION ? semi_lagrangian_courant : safety_factors[TIME_MARCHING].adv;
   return 0;
 }
 
@@ -49,10 +62,16 @@ static int decide_dt_dif(
     const domain_t * const domain,
     double * const dt
 ) {
-  const double dx = domain->dx;
-  const double dy = domain->dy;
+  const size_t ny = DOMAIN_NY(domain);
+  const double dx = DOMAIN_DX(domain);
+  const double * const dyf = domain->dyf;
+  // the narrowest cell limits the time-step size
+  double dy = dyf[1];
+  for (size_t j = 2; j <= ny; j++) {
+    dy = fmin(dy, dyf[j]);
+  }
   *dt = Re * 0.5 / ndims * pow(fmin(dx, dy), 2.);
-  *dt *= safety_factors.dif;
+  *dt *= safety_factors[TIME_MARCHING].dif;
   return 0;
 }
 
@@ -67,6 +86,11 @@ int decide_dt(
     LOGGER_FAILURE("failed to find advective time-step constraint");
     goto abort;
   }
+  // diffusive terms treated implicitly do not limit the time-step size
+  if (IMPLICIT_DIFFUSION) {
+    *dt = dt_adv;
+    return 0;
+  }
   if (0 != decide_dt_dif(domain, &dt_dif)) {
     LOGGER_FAILURE("failed to find diffusive time-step constraint");
     goto abort;
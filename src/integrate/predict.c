@@ -1,36 +1,153 @@
 #include "logger.h"
 #include "param.h"
+#include "array.h"
 #include "boundary_condition.h"
 #include "exchange_halo.h"
+#include "simd.h"
 #include "./predict.h"
 #include "./predict/compute_dux.h"
 #include "./predict/compute_duy.h"
+#include "./predict/solve_diffusion.h"
 
-static int update_ux(
+// initialise increments before the right-hand-side terms are added:
+//   the register of the low-storage Runge-Kutta scheme is scaled by alpha,
+//   which is simply reset when alpha is zero
+SIMD_DISPATCH
+static int init_increment(
     const domain_t * const domain,
-    double ** const dux,
-    double ** const weight,
-    double ** const ux
+    const size_t imin,
+    const size_t jmin,
+    const double alpha,
+    const array_view_t du_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const size_t pitch = du_view.pitch;
+  real_t * restrict const du = ARRAY_ASSUME_ALIGNED(du_view.data);
+  if (0. == alpha) {
+#pragma omp parallel for
+    for (size_t j = jmin; j <= ny; j++) {
+      for (size_t i = imin; i <= nx; i++) {
+        du[j * pitch + i] = 0.;
+      }
+    }
+  } else {
 #pragma omp parallel for
-  for (size_t j = 1; j <= ny; j++) {
-    for (size_t i = ux_imin; i <= nx; i++) {
-      ux[j][i] += dux[j][i];
+    for (size_t j = jmin; j <= ny; j++) {
+      for (size_t i = imin; i <= nx; i++) {
+        du[j * pitch + i] *= alpha;
+      }
     }
   }
+  return 0;
+}
+
+// convert the advective and diffusive terms of the current step "du"
+//   to the Adams-Bashforth increment, considering variable time-step sizes,
+//   and store the current terms for the next step
+// NOTE: Euler forward is used when the previous terms are not available
+SIMD_DISPATCH
+static int extrapolate(
+    const domain_t * const domain,
+    const size_t imin,
+    const size_t jmin,
+    const double dt,
+    const double dt_prev,
+    const array_view_t du_view,
+    const array_view_t du_prev_view
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const size_t pitch = du_view.pitch;
+  real_t * restrict const du = ARRAY_ASSUME_ALIGNED(du_view.data);
+  real_t * restrict const du_prev = ARRAY_ASSUME_ALIGNED(du_prev_view.data);
+  const double gamma = 0. == dt_prev ? 0. : 0.5 * dt / dt_prev;
 #pragma omp parallel for
-  for (size_t j = 1; j <= ny; j++) {
-    for (size_t i = ux_imin; i <= nx; i++) {
-      const double w_xm = weight[j    ][i - 1];
-      const double w_xp = weight[j    ][i    ];
-      ux[j][i] *= (
-          + 0.5 * w_xm
-          + 0.5 * w_xp
+  for (size_t j = jmin; j <= ny; j++) {
+    for (size_t i = imin; i <= nx; i++) {
+      const real_t rhs = du[j * pitch + i];
+      du[j * pitch + i] = dt * (
+          + (1. + gamma) * rhs
+          -       gamma  * du_prev[j * pitch + i]
       );
+      du_prev[j * pitch + i] = rhs;
+    }
+  }
+  return 0;
+}
+
+// relax the velocities on the faces inside the band around the body
+//   toward the velocity of the body "target" using the penalty factors,
+//   where "dy" is the heights of the faces
+// NOTE: for moving bodies, the momentum given to the fluid is accumulated
+static int penalise(
+    const domain_t * const domain,
+    const double * const dy,
+    const double target,
+    penalty_t * const penalty,
+    const array_view_t u_view
+) {
+  const size_t nitems = penalty->nitems;
+  const penalised_face_t * const faces = penalty->faces;
+  const size_t pitch = u_view.pitch;
+  real_t * restrict const u = u_view.data;
+  if (BODY_MOTION_FIXED == BODY_MOTION) {
+#pragma omp parallel for
+    for (size_t n = 0; n < nitems; n++) {
+      const penalised_face_t * const face = faces + n;
+      u[face->j * pitch + face->i] *= face->factor;
+    }
+  } else {
+    const double dx = DOMAIN_DX(domain);
+    double impulse = 0.;
+#pragma omp parallel for reduction(+: impulse)
+    for (size_t n = 0; n < nitems; n++) {
+      const penalised_face_t * const face = faces + n;
+      const double factor = face->factor;
+      real_t * const value = u + face->j * pitch + face->i;
+      const double du = (1. - factor) * (target - *value);
+      *value += du;
+      impulse += du * dx * dy[face->j];
     }
+    penalty->impulse += impulse;
   }
+  return 0;
+}
+
+// u <- u + beta * du
+SIMD_DISPATCH
+static int add_increment(
+    const domain_t * const domain,
+    const size_t imin,
+    const size_t jmin,
+    const double beta,
+    const array_view_t du_view,
+    const array_view_t u_view
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const size_t pitch = du_view.pitch;
+  const real_t * restrict const du = ARRAY_ASSUME_ALIGNED(du_view.data);
+  real_t * restrict const u = ARRAY_ASSUME_ALIGNED(u_view.data);
+#pragma omp parallel for
+  for (size_t j = jmin; j <= ny; j++) {
+    for (size_t i = imin; i <= nx; i++) {
+      u[j * pitch + i] += beta * du[j * pitch + i];
+    }
+  }
+  return 0;
+}
+
+static int update_ux(
+    const domain_t * const domain,
+    const double beta,
+    const array_view_t dux_view,
+    const body_t * const body,
+    penalty_t * const penalty,
+    real_t ** const ux
+) {
+  add_increment(domain, ux_imin,       1, beta, dux_view, array_view(ux));
+  penalise(domain, domain->dyf, body->velocity[0], penalty, array_view(ux));
   if (X_PERIODIC) {
     if (0 != exchange_halo_x(domain, ux)) {
       LOGGER_FAILURE("failed to exchange halo in x (ux)");
@@ -60,29 +177,14 @@ abort:
 
 static int update_uy(
     const domain_t * const domain,
-    double ** const duy,
-    double ** const weight,
-    double ** const uy
+    const double beta,
+    const array_view_t duy_view,
+    const body_t * const body,
+    penalty_t * const penalty,
+    real_t ** const uy
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-#pragma omp parallel for
-  for (size_t j = uy_jmin; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      uy[j][i] += duy[j][i];
-    }
-  }
-#pragma omp parallel for
-  for (size_t j = uy_jmin; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      const double w_ym = weight[j - 1][i    ];
-      const double w_yp = weight[j    ][i    ];
-      uy[j][i] *= (
-          + 0.5 * w_ym
-          + 0.5 * w_yp
-      );
-    }
-  }
+  add_increment(domain,       1, uy_jmin, beta, duy_view, array_view(uy));
+  penalise(domain, domain->dyc, body->velocity[1], penalty, array_view(uy));
   if (X_PERIODIC) {
     if (0 != exchange_halo_x(domain, uy)) {
       LOGGER_FAILURE("failed to exchange halo in x (uy)");
@@ -110,27 +212,82 @@ abort:
   return 1;
 }
 
+// dux <- alpha * dux + dt * (right-hand-side terms)
+// ux  <- ux + beta * dux
+// NOTE: (alpha, beta) = (0, 1) gives Euler forward
 int predict(
     const domain_t * const domain,
     flow_field_t * const flow_field,
     flow_solver_t * const flow_solver,
-    const double dt
+    const double dt,
+    const double alpha,
+    const double beta
 ) {
-  double ** const dux = flow_solver->dux;
-  double ** const duy = flow_solver->duy;
-  if (0 != compute_dux(domain, flow_field, dt, dux)) {
-    LOGGER_FAILURE("failed to find dux");
+  const array_view_t dux = array_view(flow_solver->dux);
+  const array_view_t duy = array_view(flow_solver->duy);
+  init_increment(domain, ux_imin,       1, alpha, dux);
+  init_increment(domain,       1, uy_jmin, alpha, duy);
+  if (TIME_MARCHING_AB2 == TIME_MARCHING) {
+    // advective and diffusive terms per unit time are extrapolated,
+    //   while the pressure gradient is not
+    //   to avoid a neutrally-stable oscillation of the pressure
+    history_t * const history = &flow_solver->history;
+    if (0 != compute_dux(domain, flow_field, 1., dux)) {
+      LOGGER_FAILURE("failed to find dux");
+      goto abort;
+    }
+    if (0 != compute_duy(domain, flow_field, 1., duy)) {
+      LOGGER_FAILURE("failed to find duy");
+      goto abort;
+    }
+    extrapolate(domain, ux_imin,       1, dt, history->dt, dux, array_view(history->dux));
+    extrapolate(domain,       1, uy_jmin, dt, history->dt, duy, array_view(history->duy));
+    history->dt = dt;
+  } else {
+    if (0 != compute_dux(domain, flow_field, dt, dux)) {
+      LOGGER_FAILURE("failed to find dux");
+      goto abort;
+    }
+    if (0 != compute_duy(domain, flow_field, dt, duy)) {
+      LOGGER_FAILURE("failed to find duy");
+      goto abort;
+    }
+  }
+  // NOTE: psi is used as a scratch array, which is free at this point
+  if (SEMI_LAGRANGIAN_ADVECTION) {
+    if (0 != compute_dux_semi_lagrangian(domain, flow_field, dt, flow_solver->psi, flow_solver->dux)) {
+      LOGGER_FAILURE("failed to advect ux");
+      goto abort;
+    }
+    if (0 != compute_duy_semi_lagrangian(domain, flow_field, dt, flow_solver->psi, flow_solver->duy)) {
+      LOGGER_FAILURE("failed to advect uy");
+      goto abort;
+    }
+  }
+  if (0 != compute_dux_pressure(domain, flow_field, dt, dux)) {
+    LOGGER_FAILURE("failed to find pressure-gradient contribution to dux");
     goto abort;
   }
-  if (0 != compute_duy(domain, flow_field, dt, duy)) {
-    LOGGER_FAILURE("failed to find duy");
+  if (0 != compute_duy_pressure(domain, flow_field, dt, duy)) {
+    LOGGER_FAILURE("failed to find pressure-gradient contribution to duy");
     goto abort;
   }
-  if (0 != update_ux(domain, dux, flow_field->weight, flow_field->ux)) {
+  // NOTE: buffers of the Poisson solver are used, which are free at this point
+  if (IMPLICIT_DIFFUSION) {
+    if (0 != solve_diffusion_ux(domain, flow_solver, dt, flow_solver->dux)) {
+      LOGGER_FAILURE("failed to treat diffusive terms of ux implicitly");
+      goto abort;
+    }
+    if (0 != solve_diffusion_uy(domain, flow_solver, dt, flow_solver->duy)) {
+      LOGGER_FAILURE("failed to treat diffusive terms of uy implicitly");
+      goto abort;
+    }
+  }
+  if (0 != update_ux(domain, beta, dux, &flow_field->body, &flow_field->penalty_ux, flow_field->ux)) {
     LOGGER_FAILURE("failed to update ux");
     goto abort;
   }
-  if (0 != update_uy(domain, duy, flow_field->weight, flow_field->uy)) {
+  if (0 != update_uy(domain, beta, duy, &flow_field->body, &flow_field->penalty_uy, flow_field->uy)) {
     LOGGER_FAILURE("failed to update uy");
     goto abort;
   }
@@ -9,7 +9,9 @@ extern int predict(
     const domain_t * const domain,
     flow_field_t * const flow_field,
     flow_solver_t * const flow_solver,
-    const double dt
+    const double dt,
+    const double alpha,
+    const double beta
 );
 
 #endif // PREDICT_H
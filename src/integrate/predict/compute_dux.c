@@ -5,30 +5,49 @@
 #include "./compute_dux/difx.h"
 #include "./compute_dux/dify.h"
 #include "./compute_dux/pres.h"
+#include "./compute_dux/advsl.h"
 
 int compute_dux(
     const domain_t * const domain,
     const flow_field_t * const flow_field,
     const double dt,
-    double ** const dux
+    const array_view_t dux
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-#pragma omp parallel for
-  for (size_t j = 1; j <= ny; j++) {
-    for (size_t i = ux_imin; i <= nx; i++) {
-      dux[j][i] = 0.;
-    }
-  }
-  double ** const ux = flow_field->ux;
-  double ** const uy = flow_field->uy;
-  double ** const  p = flow_field-> p;
+  const array_view_t ux = array_view(flow_field->ux);
+  const array_view_t uy = array_view(flow_field->uy);
   const double c = 1. / Re;
-  ux_advx(domain,     ux, dt, dux);
-  ux_advy(domain, uy, ux, dt, dux);
+  // advective terms are treated separately by the semi-Lagrangian scheme
+  if (!SEMI_LAGRANGIAN_ADVECTION) {
+    ux_advx(domain,     ux, dt, dux);
+    ux_advy(domain, uy, ux, dt, dux);
+  }
   ux_difx(domain,  c, ux, dt, dux);
   ux_dify(domain,  c, ux, dt, dux);
-  ux_pres(domain,      p, dt, dux);
+  return 0;
+}
+
+// NOTE: "buf" is used as a scratch array
+int compute_dux_semi_lagrangian(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const dux
+) {
+  real_t ** const ux = flow_field->ux;
+  real_t ** const uy = flow_field->uy;
+  ux_advsl(domain, ux, uy, dt, buf, dux);
+  return 0;
+}
+
+int compute_dux_pressure(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    const array_view_t dux
+) {
+  const array_view_t p = array_view(flow_field->p);
+  ux_pres(domain, p, dt, dux);
   return 0;
 }
 
@@ -1,14 +1,34 @@
 #if !defined(COMPUTE_DUX_H)
 #define COMPUTE_DUX_H
 
+#include "array.h"
 #include "domain.h"
 #include "flow_field.h"
 
+// add "dt" times the advective and diffusive terms of the ux equation to "dux",
+//   which should be initialised by the caller
 int compute_dux(
     const domain_t * const domain,
     const flow_field_t * const flow_field,
     const double dt,
-    double ** const dux
+    const array_view_t dux
+);
+
+// add the change of ux advected over "dt" by the semi-Lagrangian scheme to "dux"
+int compute_dux_semi_lagrangian(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const dux
+);
+
+// add "dt" times the pressure-gradient term of the ux equation to "dux"
+int compute_dux_pressure(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    const array_view_t dux
 );
 
 #endif // COMPUTE_DUX_H
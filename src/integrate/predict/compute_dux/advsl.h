@@ -0,0 +1,16 @@
+#if !defined(ADVSL_H)
+#define ADVSL_H
+
+#include "domain.h"
+#include "real.h"
+
+extern int ux_advsl(
+    const domain_t * const domain,
+    real_t ** const ux,
+    real_t ** const uy,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const dux
+);
+
+#endif // ADVSL_H
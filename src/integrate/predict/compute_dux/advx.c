@@ -1,26 +1,31 @@
+#include "simd.h"
 #include "./advx.h"
 
+SIMD_DISPATCH
 int ux_advx(
     const domain_t * const domain,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const array_view_t ux_view,
+    const real_t dt,
+    const array_view_t dux_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const real_t dx = DOMAIN_DX(domain);
+  const size_t pitch = dux_view.pitch;
+  const real_t * restrict const ux = ARRAY_ASSUME_ALIGNED(ux_view.data);
+  real_t * restrict const dux = ARRAY_ASSUME_ALIGNED(dux_view.data);
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = ux_imin; i <= nx; i++) {
-      const double ux_xm = + 0.5 * ux[j    ][i - 1]
-                           + 0.5 * ux[j    ][i    ];
-      const double ux_xp = + 0.5 * ux[j    ][i    ]
-                           + 0.5 * ux[j    ][i + 1];
-      const double dux_xm = - ux[j    ][i - 1]
-                            + ux[j    ][i    ];
-      const double dux_xp = - ux[j    ][i    ]
-                            + ux[j    ][i + 1];
-      dux[j][i] -= dt * (
+      const real_t ux_xm = + 0.5 * ux[(j    ) * pitch + (i - 1)]
+                           + 0.5 * ux[(j    ) * pitch + (i    )];
+      const real_t ux_xp = + 0.5 * ux[(j    ) * pitch + (i    )]
+                           + 0.5 * ux[(j    ) * pitch + (i + 1)];
+      const real_t dux_xm = - ux[(j    ) * pitch + (i - 1)]
+                            + ux[(j    ) * pitch + (i    )];
+      const real_t dux_xp = - ux[(j    ) * pitch + (i    )]
+                            + ux[(j    ) * pitch + (i + 1)];
+      dux[j * pitch + i] -= dt * (
           + 0.5 / dx * ux_xm * dux_xm
           + 0.5 / dx * ux_xp * dux_xp
       );
@@ -49,17 +54,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** ux = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** ux = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &ux);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -76,13 +82,14 @@ int main(
       answer[j][i] = - get_ux(&domain, x, y) * get_duxdx(&domain, x, y);
     }
   }
-  ux_advx(&domain, ux, 1., result);
+  ux_advx(&domain, array_view(ux), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&ux);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
@@ -1,13 +1,14 @@
 #if !defined(ADVX_H)
 #define ADVX_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int ux_advx(
     const domain_t * const domain,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const array_view_t ux,
+    const real_t dt,
+    const array_view_t dux
 );
 
 #endif // ADVX_H
@@ -1,27 +1,34 @@
+#include "simd.h"
 #include "./advy.h"
 
+SIMD_DISPATCH
 int ux_advy(
     const domain_t * const domain,
-    double ** const uy,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const array_view_t uy_view,
+    const array_view_t ux_view,
+    const real_t dt,
+    const array_view_t dux_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dy = domain->dy;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double * const dyf = domain->dyf;
+  const size_t pitch = dux_view.pitch;
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(uy_view.data);
+  const real_t * restrict const ux = ARRAY_ASSUME_ALIGNED(ux_view.data);
+  real_t * restrict const dux = ARRAY_ASSUME_ALIGNED(dux_view.data);
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
+    const real_t dy = dyf[j];
     for (size_t i = ux_imin; i <= nx; i++) {
-      const double uy_ym = + 0.5 * uy[j    ][i - 1]
-                           + 0.5 * uy[j    ][i    ];
-      const double uy_yp = + 0.5 * uy[j + 1][i - 1]
-                           + 0.5 * uy[j + 1][i    ];
-      const double dux_ym = - ux[j - 1][i    ]
-                            + ux[j    ][i    ];
-      const double dux_yp = - ux[j    ][i    ]
-                            + ux[j + 1][i    ];
-      dux[j][i] -= dt * (
+      const real_t uy_ym = + 0.5 * uy[(j    ) * pitch + (i - 1)]
+                           + 0.5 * uy[(j    ) * pitch + (i    )];
+      const real_t uy_yp = + 0.5 * uy[(j + 1) * pitch + (i - 1)]
+                           + 0.5 * uy[(j + 1) * pitch + (i    )];
+      const real_t dux_ym = - ux[(j - 1) * pitch + (i    )]
+                            + ux[(j    ) * pitch + (i    )];
+      const real_t dux_yp = - ux[(j    ) * pitch + (i    )]
+                            + ux[(j + 1) * pitch + (i    )];
+      dux[j * pitch + i] -= dt * (
           + 0.5 / dy * uy_ym * dux_ym
           + 0.5 / dy * uy_yp * dux_yp
       );
@@ -50,18 +57,19 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** ux = NULL;
-  double ** uy = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** ux = NULL;
+  real_t ** uy = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &ux);
   array_init(nx + 2, ny + 2, &uy);
   array_init(nx + 2, ny + 2, &result);
@@ -80,7 +88,7 @@ int main(
       answer[j][i] = - get_uy(&domain, x, y) * get_duxdy(&domain, x, y);
     }
   }
-  ux_advy(&domain, uy, ux, 1., result);
+  ux_advy(&domain, array_view(uy), array_view(ux), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
@@ -88,6 +96,7 @@ int main(
   array_finalize(&uy);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
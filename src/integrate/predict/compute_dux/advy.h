@@ -1,14 +1,15 @@
 #if !defined(ADVY_H)
 #define ADVY_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int ux_advy(
     const domain_t * const domain,
-    double ** const uy,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const array_view_t uy,
+    const array_view_t ux,
+    const real_t dt,
+    const array_view_t dux
 );
 
 #endif // ADVY_H
@@ -1,22 +1,27 @@
+#include "simd.h"
 #include "./difx.h"
 
+SIMD_DISPATCH
 int ux_difx(
     const domain_t * const domain,
-    const double c,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const real_t c,
+    const array_view_t ux_view,
+    const real_t dt,
+    const array_view_t dux_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const real_t dx = DOMAIN_DX(domain);
+  const size_t pitch = dux_view.pitch;
+  const real_t * restrict const ux = ARRAY_ASSUME_ALIGNED(ux_view.data);
+  real_t * restrict const dux = ARRAY_ASSUME_ALIGNED(dux_view.data);
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = ux_imin; i <= nx; i++) {
-      dux[j][i] += dt * c / dx / dx * (
-          + 1. * ux[j    ][i - 1]
-          - 2. * ux[j    ][i    ]
-          + 1. * ux[j    ][i + 1]
+      dux[j * pitch + i] += dt * c / dx / dx * (
+          + 1. * ux[(j    ) * pitch + (i - 1)]
+          - 2. * ux[(j    ) * pitch + (i    )]
+          + 1. * ux[(j    ) * pitch + (i + 1)]
       );
     }
   }
@@ -43,17 +48,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** ux = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** ux = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &ux);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -70,13 +76,14 @@ int main(
       answer[j][i] = get_d2uxdx2(&domain, x, y);
     }
   }
-  ux_difx(&domain, 1., ux, 1., result);
+  ux_difx(&domain, 1., array_view(ux), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&ux);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
@@ -1,14 +1,15 @@
 #if !defined(DIFY_H)
 #define DIFY_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int ux_dify(
     const domain_t * const domain,
-    const double c,
-    double ** const ux,
-    const double dt,
-    double ** const dux
+    const real_t c,
+    const array_view_t ux,
+    const real_t dt,
+    const array_view_t dux
 );
 
 #endif // DIFY_H
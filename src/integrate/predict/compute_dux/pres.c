@@ -1,20 +1,25 @@
+#include "simd.h"
 #include "./pres.h"
 
+SIMD_DISPATCH
 int ux_pres(
     const domain_t * const domain,
-    double ** const p,
-    const double dt,
-    double ** const dux
+    const array_view_t p_view,
+    const real_t dt,
+    const array_view_t dux_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const real_t dx = DOMAIN_DX(domain);
+  const size_t pitch = dux_view.pitch;
+  const real_t * restrict const p = ARRAY_ASSUME_ALIGNED(p_view.data);
+  real_t * restrict const dux = ARRAY_ASSUME_ALIGNED(dux_view.data);
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = ux_imin; i <= nx; i++) {
-      dux[j][i] -= dt / dx * (
-          - p[j    ][i - 1]
-          + p[j    ][i    ]
+      dux[j * pitch + i] -= dt / dx * (
+          - p[(j    ) * pitch + (i - 1)]
+          + p[(j    ) * pitch + (i    )]
       );
     }
   }
@@ -41,17 +46,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** p = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** p = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &p);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -68,13 +74,14 @@ int main(
       answer[j][i] = - get_dpdx(&domain, x, y);
     }
   }
-  ux_pres(&domain, p, 1., result);
+  ux_pres(&domain, array_view(p), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&p);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
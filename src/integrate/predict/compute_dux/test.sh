@@ -1,6 +1,6 @@
 #!/bin/bash
 
-available_targets=(advx advy difx dify pres)
+available_targets=(advx advy difx dify pres advsl)
 
 target=${1}
 
@@ -29,6 +29,7 @@ for resol in ${resols[@]}; do
     ../../../array.c \
     ../../../domain.c \
     ../test_util.c \
+    ../semi_lagrangian.c \
     ./test_util.c \
     ${target}.c \
     -o a.out \
@@ -19,9 +19,8 @@ double get_y(
     const domain_t * const domain,
     const size_t j
 ) {
-  const double dy = domain->dy;
   assert(0 < j);
-  return 0.5 * (2 * j - 1) * dy;
+  return domain->yc[j];
 }
 
 double get_duxdx(
@@ -5,30 +5,49 @@
 #include "./compute_duy/difx.h"
 #include "./compute_duy/dify.h"
 #include "./compute_duy/pres.h"
+#include "./compute_duy/advsl.h"
 
 int compute_duy(
     const domain_t * const domain,
     const flow_field_t * const flow_field,
     const double dt,
-    double ** const duy
+    const array_view_t duy
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-#pragma omp parallel for
-  for (size_t j = uy_jmin; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      duy[j][i] = 0.;
-    }
-  }
-  double ** const ux = flow_field->ux;
-  double ** const uy = flow_field->uy;
-  double ** const  p = flow_field-> p;
+  const array_view_t ux = array_view(flow_field->ux);
+  const array_view_t uy = array_view(flow_field->uy);
   const double c = 1. / Re;
-  uy_advx(domain, ux, uy, dt, duy);
-  uy_advy(domain,     uy, dt, duy);
+  // advective terms are treated separately by the semi-Lagrangian scheme
+  if (!SEMI_LAGRANGIAN_ADVECTION) {
+    uy_advx(domain, ux, uy, dt, duy);
+    uy_advy(domain,     uy, dt, duy);
+  }
   uy_difx(domain,  c, uy, dt, duy);
   uy_dify(domain,  c, uy, dt, duy);
-  uy_pres(domain,      p, dt, duy);
+  return 0;
+}
+
+// NOTE: "buf" is used as a scratch array
+int compute_duy_semi_lagrangian(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const duy
+) {
+  real_t ** const ux = flow_field->ux;
+  real_t ** const uy = flow_field->uy;
+  uy_advsl(domain, ux, uy, dt, buf, duy);
+  return 0;
+}
+
+int compute_duy_pressure(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    const array_view_t duy
+) {
+  const array_view_t p = array_view(flow_field->p);
+  uy_pres(domain, p, dt, duy);
   return 0;
 }
 
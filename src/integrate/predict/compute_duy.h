@@ -1,14 +1,34 @@
 #if !defined(COMPUTE_DUY_H)
 #define COMPUTE_DUY_H
 
+#include "array.h"
 #include "domain.h"
 #include "flow_field.h"
 
+// add "dt" times the advective and diffusive terms of the uy equation to "duy",
+//   which should be initialised by the caller
 int compute_duy(
     const domain_t * const domain,
     const flow_field_t * const flow_field,
     const double dt,
-    double ** const duy
+    const array_view_t duy
+);
+
+// add the change of uy advected over "dt" by the semi-Lagrangian scheme to "duy"
+int compute_duy_semi_lagrangian(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const duy
+);
+
+// add "dt" times the pressure-gradient term of the uy equation to "duy"
+int compute_duy_pressure(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const double dt,
+    const array_view_t duy
 );
 
 #endif // COMPUTE_DUY_H
@@ -0,0 +1,116 @@
+#include "../semi_lagrangian.h"
+#include "./advsl.h"
+
+// advective terms in both directions by the semi-Lagrangian scheme,
+//   replacing uy_advx and uy_advy
+// NOTE: "buf" is used as a scratch array
+int uy_advsl(
+    const domain_t * const domain,
+    real_t ** const ux,
+    real_t ** const uy,
+    const double dt,
+    real_t ** const buf,
+    real_t ** const duy
+) {
+  const semi_lagrangian_layout_t layout = semi_lagrangian_layout_uy(domain);
+  return semi_lagrangian_advect(domain, &layout, ux, uy, dt, uy, buf, duy);
+}
+
+#if defined(TEST)
+
+#include <stdio.h> // printf
+#include <stdlib.h> // strtol
+#include "array.h"
+#include "domain.h"
+#include "../test_util.h"
+#include "./test_util.h"
+
+// exact departure point in the frozen velocity field,
+//   found by the classical Runge-Kutta scheme with small steps
+static void find_departure(
+    const domain_t * const domain,
+    const double dt,
+    double * const x,
+    double * const y
+) {
+  const size_t nsteps = 64;
+  const double h = - dt / nsteps;
+  for (size_t n = 0; n < nsteps; n++) {
+    const double kx0 = get_ux(domain, *x, *y);
+    const double ky0 = get_uy(domain, *x, *y);
+    const double kx1 = get_ux(domain, *x + 0.5 * h * kx0, *y + 0.5 * h * ky0);
+    const double ky1 = get_uy(domain, *x + 0.5 * h * kx0, *y + 0.5 * h * ky0);
+    const double kx2 = get_ux(domain, *x + 0.5 * h * kx1, *y + 0.5 * h * ky1);
+    const double ky2 = get_uy(domain, *x + 0.5 * h * kx1, *y + 0.5 * h * ky1);
+    const double kx3 = get_ux(domain, *x + h * kx2, *y + h * ky2);
+    const double ky3 = get_uy(domain, *x + h * kx2, *y + h * ky2);
+    *x += h / 6. * (kx0 + 2. * kx1 + 2. * kx2 + kx3);
+    *y += h / 6. * (ky0 + 2. * ky1 + 2. * ky2 + ky3);
+  }
+}
+
+int main(
+    int argc,
+    char * argv[]
+) {
+  if (2 != argc) {
+    printf("invalid number of arguments: %d, expected 2\n", argc);
+    return 1;
+  }
+  const double length = 1.;
+  const size_t nx = strtol(argv[1], NULL, 10);
+  const size_t ny = strtol(argv[1], NULL, 10);
+  domain_t domain = {
+    .lx = length,
+    .ly = length,
+    .nx = nx,
+    .ny = ny,
+    .dx = length / nx,
+  };
+  // NOTE: semi-Lagrangian advection assumes uniform grids
+  domain_init_y(0., &domain);
+  // Courant number is fixed, so that dt is refined together with the grid
+  // NOTE: changes over dt are compared with the exact solution
+  //       of the linear advection in the frozen velocity field
+  const double dt = 0.5 * domain.dx;
+  real_t ** ux = NULL;
+  real_t ** uy = NULL;
+  real_t ** buf = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
+  array_init(nx + 2, ny + 2, &ux);
+  array_init(nx + 2, ny + 2, &uy);
+  array_init(nx + 2, ny + 2, &buf);
+  array_init(nx + 2, ny + 2, &result);
+  array_init(nx + 2, ny + 2, &answer);
+  for (size_t j = uy_jmin; j <= ny; j++) {
+    for (size_t i = 1; i <= nx; i++) {
+      result[j][i] = 0.;
+    }
+  }
+  get_array_ux(&domain, ux);
+  get_array_uy(&domain, uy);
+  for (size_t j = uy_jmin; j <= ny; j++) {
+    const double y = get_y(&domain, j);
+    for (size_t i = 1; i <= nx; i++) {
+      const double x = get_x(&domain, i);
+      double xd = x;
+      double yd = y;
+      find_departure(&domain, dt, &xd, &yd);
+      answer[j][i] = get_uy(&domain, xd, yd) - get_uy(&domain, x, y);
+    }
+  }
+  uy_advsl(&domain, ux, uy, dt, buf, result);
+  double error[2] = {0., 0.};
+  check_error(&domain, answer, result, error);
+  printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
+  array_finalize(&ux);
+  array_finalize(&uy);
+  array_finalize(&buf);
+  array_finalize(&result);
+  array_finalize(&answer);
+  domain_finalize(&domain);
+  return 0;
+}
+
+#endif // TEST
@@ -1,27 +1,38 @@
+#include "simd.h"
 #include "./advx.h"
 
+SIMD_DISPATCH
 int uy_advx(
     const domain_t * const domain,
-    double ** const ux,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const array_view_t ux_view,
+    const array_view_t uy_view,
+    const real_t dt,
+    const array_view_t duy_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const real_t dx = DOMAIN_DX(domain);
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
+  const size_t pitch = duy_view.pitch;
+  const real_t * restrict const ux = ARRAY_ASSUME_ALIGNED(ux_view.data);
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(uy_view.data);
+  real_t * restrict const duy = ARRAY_ASSUME_ALIGNED(duy_view.data);
 #pragma omp parallel for
   for (size_t j = uy_jmin; j <= ny; j++) {
+    // weights to interpolate ux from the cell centers to the cell face
+    const real_t wm = 0.5 * dyf[j    ] / dyc[j];
+    const real_t wp = 0.5 * dyf[j - 1] / dyc[j];
     for (size_t i = 1; i <= nx; i++) {
-      const double ux_xm = + 0.5 * ux[j - 1][i    ]
-                           + 0.5 * ux[j    ][i    ];
-      const double ux_xp = + 0.5 * ux[j - 1][i + 1]
-                           + 0.5 * ux[j    ][i + 1];
-      const double duy_xm = - uy[j    ][i - 1]
-                            + uy[j    ][i    ];
-      const double duy_xp = - uy[j    ][i    ]
-                            + uy[j    ][i + 1];
-      duy[j][i] -= dt * (
+      const real_t ux_xm = + wm * ux[(j - 1) * pitch + (i    )]
+                           + wp * ux[(j    ) * pitch + (i    )];
+      const real_t ux_xp = + wm * ux[(j - 1) * pitch + (i + 1)]
+                           + wp * ux[(j    ) * pitch + (i + 1)];
+      const real_t duy_xm = - uy[(j    ) * pitch + (i - 1)]
+                            + uy[(j    ) * pitch + (i    )];
+      const real_t duy_xp = - uy[(j    ) * pitch + (i    )]
+                            + uy[(j    ) * pitch + (i + 1)];
+      duy[j * pitch + i] -= dt * (
           + 0.5 / dx * ux_xm * duy_xm
           + 0.5 / dx * ux_xp * duy_xp
       );
@@ -50,18 +61,19 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** ux = NULL;
-  double ** uy = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** ux = NULL;
+  real_t ** uy = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &ux);
   array_init(nx + 2, ny + 2, &uy);
   array_init(nx + 2, ny + 2, &result);
@@ -80,7 +92,7 @@ int main(
       answer[j][i] = - get_ux(&domain, x, y) * get_duydx(&domain, x, y);
     }
   }
-  uy_advx(&domain, ux, uy, 1., result);
+  uy_advx(&domain, array_view(ux), array_view(uy), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
@@ -88,6 +100,7 @@ int main(
   array_finalize(&uy);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
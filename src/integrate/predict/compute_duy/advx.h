@@ -1,14 +1,15 @@
 #if !defined(ADVX_H)
 #define ADVX_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int uy_advx(
     const domain_t * const domain,
-    double ** const ux,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const array_view_t ux,
+    const array_view_t uy,
+    const real_t dt,
+    const array_view_t duy
 );
 
 #endif // ADVX_H
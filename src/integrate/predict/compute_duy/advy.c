@@ -1,26 +1,32 @@
+#include "simd.h"
 #include "./advy.h"
 
+SIMD_DISPATCH
 int uy_advy(
     const domain_t * const domain,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const array_view_t uy_view,
+    const real_t dt,
+    const array_view_t duy_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dy = domain->dy;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double * const dyc = domain->dyc;
+  const size_t pitch = duy_view.pitch;
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(uy_view.data);
+  real_t * restrict const duy = ARRAY_ASSUME_ALIGNED(duy_view.data);
 #pragma omp parallel for
   for (size_t j = uy_jmin; j <= ny; j++) {
+    const real_t dy = dyc[j];
     for (size_t i = 1; i <= nx; i++) {
-      const double uy_ym = + 0.5 * uy[j - 1][i    ]
-                           + 0.5 * uy[j    ][i    ];
-      const double uy_yp = + 0.5 * uy[j    ][i    ]
-                           + 0.5 * uy[j + 1][i    ];
-      const double duy_ym = - uy[j - 1][i    ]
-                            + uy[j    ][i    ];
-      const double duy_yp = - uy[j    ][i    ]
-                            + uy[j + 1][i    ];
-      duy[j][i] -= dt * (
+      const real_t uy_ym = + 0.5 * uy[(j - 1) * pitch + (i    )]
+                           + 0.5 * uy[(j    ) * pitch + (i    )];
+      const real_t uy_yp = + 0.5 * uy[(j    ) * pitch + (i    )]
+                           + 0.5 * uy[(j + 1) * pitch + (i    )];
+      const real_t duy_ym = - uy[(j - 1) * pitch + (i    )]
+                            + uy[(j    ) * pitch + (i    )];
+      const real_t duy_yp = - uy[(j    ) * pitch + (i    )]
+                            + uy[(j + 1) * pitch + (i    )];
+      duy[j * pitch + i] -= dt * (
           + 0.5 / dy * uy_ym * duy_ym
           + 0.5 / dy * uy_yp * duy_yp
       );
@@ -49,17 +55,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** uy = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** uy = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &uy);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -76,13 +83,14 @@ int main(
       answer[j][i] = - get_uy(&domain, x, y) * get_duydy(&domain, x, y);
     }
   }
-  uy_advy(&domain, uy, 1., result);
+  uy_advy(&domain, array_view(uy), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&uy);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
@@ -1,13 +1,14 @@
 #if !defined(ADVY_H)
 #define ADVY_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int uy_advy(
     const domain_t * const domain,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const array_view_t uy,
+    const real_t dt,
+    const array_view_t duy
 );
 
 #endif // ADVY_H
@@ -1,22 +1,27 @@
+#include "simd.h"
 #include "./difx.h"
 
+SIMD_DISPATCH
 int uy_difx(
     const domain_t * const domain,
-    const double c,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const real_t c,
+    const array_view_t uy_view,
+    const real_t dt,
+    const array_view_t duy_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const real_t dx = DOMAIN_DX(domain);
+  const size_t pitch = duy_view.pitch;
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(uy_view.data);
+  real_t * restrict const duy = ARRAY_ASSUME_ALIGNED(duy_view.data);
 #pragma omp parallel for
   for (size_t j = uy_jmin; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
-      duy[j][i] += dt * c / dx / dx * (
-          + 1. * uy[j    ][i - 1]
-          - 2. * uy[j    ][i    ]
-          + 1. * uy[j    ][i + 1]
+      duy[j * pitch + i] += dt * c / dx / dx * (
+          + 1. * uy[(j    ) * pitch + (i - 1)]
+          - 2. * uy[(j    ) * pitch + (i    )]
+          + 1. * uy[(j    ) * pitch + (i + 1)]
       );
     }
   }
@@ -43,17 +48,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** uy = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** uy = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &uy);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -70,13 +76,14 @@ int main(
       answer[j][i] = get_d2uydx2(&domain, x, y);
     }
   }
-  uy_difx(&domain, 1., uy, 1., result);
+  uy_difx(&domain, 1., array_view(uy), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&uy);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
@@ -1,14 +1,15 @@
 #if !defined(DIFX_H)
 #define DIFX_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int uy_difx(
     const domain_t * const domain,
-    const double c,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const real_t c,
+    const array_view_t uy,
+    const real_t dt,
+    const array_view_t duy
 );
 
 #endif // DIFX_H
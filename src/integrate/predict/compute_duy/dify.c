@@ -1,22 +1,32 @@
+#include "simd.h"
 #include "./dify.h"
 
+SIMD_DISPATCH
 int uy_dify(
     const domain_t * const domain,
-    const double c,
-    double ** const uy,
-    const double dt,
-    double ** const duy
+    const real_t c,
+    const array_view_t uy_view,
+    const real_t dt,
+    const array_view_t duy_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dy = domain->dy;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
+  const size_t pitch = duy_view.pitch;
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(uy_view.data);
+  real_t * restrict const duy = ARRAY_ASSUME_ALIGNED(duy_view.data);
 #pragma omp parallel for
   for (size_t j = uy_jmin; j <= ny; j++) {
+    // ratios of the distances, which are unity for uniform grids
+    const real_t dy = dyc[j];
+    const real_t rm = dyc[j] / dyf[j - 1];
+    const real_t rp = dyc[j] / dyf[j    ];
     for (size_t i = 1; i <= nx; i++) {
-      duy[j][i] += dt * c / dy / dy * (
-          + 1. * uy[j - 1][i    ]
-          - 2. * uy[j    ][i    ]
-          + 1. * uy[j + 1][i    ]
+      duy[j * pitch + i] += dt * c / dy / dy * (
+          +  rm       * uy[(j - 1) * pitch + (i    )]
+          - (rm + rp) * uy[(j    ) * pitch + (i    )]
+          +       rp  * uy[(j + 1) * pitch + (i    )]
       );
     }
   }
@@ -43,17 +53,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** uy = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** uy = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &uy);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -70,13 +81,14 @@ int main(
       answer[j][i] = get_d2uydy2(&domain, x, y);
     }
   }
-  uy_dify(&domain, 1., uy, 1., result);
+  uy_dify(&domain, 1., array_view(uy), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&uy);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
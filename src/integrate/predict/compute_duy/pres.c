@@ -1,20 +1,26 @@
+#include "simd.h"
 #include "./pres.h"
 
+SIMD_DISPATCH
 int uy_pres(
     const domain_t * const domain,
-    double ** const p,
-    const double dt,
-    double ** const duy
+    const array_view_t p_view,
+    const real_t dt,
+    const array_view_t duy_view
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dy = domain->dy;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double * const dyc = domain->dyc;
+  const size_t pitch = duy_view.pitch;
+  const real_t * restrict const p = ARRAY_ASSUME_ALIGNED(p_view.data);
+  real_t * restrict const duy = ARRAY_ASSUME_ALIGNED(duy_view.data);
 #pragma omp parallel for
   for (size_t j = uy_jmin; j <= ny; j++) {
+    const real_t dy = dyc[j];
     for (size_t i = 1; i <= nx; i++) {
-      duy[j][i] -= dt / dy * (
-          - p[j - 1][i    ]
-          + p[j    ][i    ]
+      duy[j * pitch + i] -= dt / dy * (
+          - p[(j - 1) * pitch + (i    )]
+          + p[(j    ) * pitch + (i    )]
       );
     }
   }
@@ -41,17 +47,18 @@ int main(
   const double length = 1.;
   const size_t nx = strtol(argv[1], NULL, 10);
   const size_t ny = strtol(argv[1], NULL, 10);
-  const domain_t domain = {
+  domain_t domain = {
     .lx = length,
     .ly = length,
     .nx = nx,
     .ny = ny,
     .dx = length / nx,
-    .dy = length / ny,
   };
-  double ** p = NULL;
-  double ** result = NULL;
-  double ** answer = NULL;
+  // cell faces are clustered toward the edges to test non-uniform spacings
+  domain_init_y(1., &domain);
+  real_t ** p = NULL;
+  real_t ** result = NULL;
+  real_t ** answer = NULL;
   array_init(nx + 2, ny + 2, &p);
   array_init(nx + 2, ny + 2, &result);
   array_init(nx + 2, ny + 2, &answer);
@@ -68,13 +75,14 @@ int main(
       answer[j][i] = - get_dpdy(&domain, x, y);
     }
   }
-  uy_pres(&domain, p, 1., result);
+  uy_pres(&domain, array_view(p), 1., array_view(result));
   double error[2] = {0., 0.};
   check_error(&domain, answer, result, error);
   printf("%6zu % .15e % .15e\n", nx, error[0], error[1]);
   array_finalize(&p);
   array_finalize(&result);
   array_finalize(&answer);
+  domain_finalize(&domain);
   return 0;
 }
 
@@ -1,13 +1,14 @@
 #if !defined(PRES_H)
 #define PRES_H
 
+#include "array.h"
 #include "domain.h"
 
 extern int uy_pres(
     const domain_t * const domain,
-    double ** const p,
-    const double dt,
-    double ** const duy
+    const array_view_t p,
+    const real_t dt,
+    const array_view_t duy
 );
 
 #endif // PRES_H
@@ -19,9 +19,8 @@ double get_y(
     const domain_t * const domain,
     const size_t j
 ) {
-  const double dy = domain->dy;
   assert(0 < j);
-  return 0.5 * (2 * j - 2) * dy;
+  return domain->yf[j];
 }
 
 double get_duydx(
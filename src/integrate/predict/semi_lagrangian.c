@@ -0,0 +1,254 @@
+#include <stdbool.h> // bool
+#include "./semi_lagrangian.h"
+
+semi_lagrangian_layout_t semi_lagrangian_layout_ux(
+    const domain_t * const domain
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  return (semi_lagrangian_layout_t){
+    .xoffset = 1.,
+    .yoffset = 0.5,
+    .ilo = 1,
+    .ihi = X_PERIODIC ? nx : nx + 1,
+    .jlo = 1,
+    .jhi = ny,
+    .imin = ux_imin,
+    .jmin = 1,
+  };
+}
+
+semi_lagrangian_layout_t semi_lagrangian_layout_uy(
+    const domain_t * const domain
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  return (semi_lagrangian_layout_t){
+    .xoffset = 0.5,
+    .yoffset = 1.,
+    .ilo = 1,
+    .ihi = nx,
+    .jlo = 1,
+    .jhi = Y_PERIODIC ? ny : ny + 1,
+    .imin = 1,
+    .jmin = uy_jmin,
+  };
+}
+
+// NOTE: fmin / fmax are not used in the following functions,
+//       as they are library calls unless finite math is assumed
+static inline double min2(
+    const double a,
+    const double b
+) {
+  return a < b ? a : b;
+}
+
+static inline double max2(
+    const double a,
+    const double b
+) {
+  return a < b ? b : a;
+}
+
+// find the two neighbouring indices and the weight of the latter
+//   for a position "s" normalised by the grid spacing:
+//   indices are wrapped in periodic directions,
+//   while positions are clamped to [lo, hi] otherwise
+// NOTE: departure points are assumed to be less than one period away,
+//       so that a single wrap is sufficient
+static inline void locate(
+    const bool periodic,
+    const size_t lo,
+    const size_t hi,
+    const double s,
+    size_t * const n0,
+    size_t * const n1,
+    double * const w
+) {
+  if (periodic) {
+    const long period = hi - lo + 1;
+    const long f = (long)s - (s < (long)s);
+    long n = f - (long)lo;
+    n += n < 0 ? period : 0;
+    n -= period <= n ? period : 0;
+    *n0 = lo + n;
+    *n1 = hi == *n0 ? lo : *n0 + 1;
+    *w = s - f;
+  } else {
+    const double t = min2(max2(s, lo), hi);
+    const size_t f = (size_t)t;
+    *n0 = f < hi ? f : hi - 1;
+    *n1 = *n0 + 1;
+    *w = t - *n0;
+  }
+}
+
+// bilinear interpolation of "phi" at (x, y),
+//   optionally giving the extrema of the four neighbours
+// NOTE: positions are normalised by the grid spacings
+static inline double interpolate(
+    const semi_lagrangian_layout_t * const layout,
+    real_t ** const phi,
+    const double x,
+    const double y,
+    double * const min,
+    double * const max
+) {
+  size_t i0 = 0, i1 = 0, j0 = 0, j1 = 0;
+  double wx = 0., wy = 0.;
+  locate(X_PERIODIC, layout->ilo, layout->ihi, x + layout->xoffset, &i0, &i1, &wx);
+  locate(Y_PERIODIC, layout->jlo, layout->jhi, y + layout->yoffset, &j0, &j1, &wy);
+  const double phi00 = phi[j0][i0];
+  const double phi01 = phi[j0][i1];
+  const double phi10 = phi[j1][i0];
+  const double phi11 = phi[j1][i1];
+  if (min && max) {
+    *min = min2(min2(phi00, phi01), min2(phi10, phi11));
+    *max = max2(max2(phi00, phi01), max2(phi10, phi11));
+  }
+  return
+    + (1. - wy) * (1. - wx) * phi00
+    + (1. - wy) * (     wx) * phi01
+    + (     wy) * (1. - wx) * phi10
+    + (     wy) * (     wx) * phi11;
+}
+
+// fixed stencil to interpolate a variable
+//   onto the nodes of another variable,
+//   which are shifted by zero or half grid spacings
+typedef struct {
+  long di;
+  long dj;
+  double wx;
+  double wy;
+} shift_t;
+
+static shift_t find_shift(
+    const semi_lagrangian_layout_t * const from,
+    const semi_lagrangian_layout_t * const to
+) {
+  const double sx = from->xoffset - to->xoffset;
+  const double sy = from->yoffset - to->yoffset;
+  const long di = sx < 0. ? -1 : 0;
+  const long dj = sy < 0. ? -1 : 0;
+  return (shift_t){
+    .di = di,
+    .dj = dj,
+    .wx = sx - di,
+    .wy = sy - dj,
+  };
+}
+
+// interpolate "phi" onto the node [j][i] of another variable,
+//   which only refers to the values inside the halo
+static inline double interpolate_at_node(
+    const shift_t * const shift,
+    real_t ** const phi,
+    const size_t i,
+    const size_t j
+) {
+  const size_t i0 = i + shift->di;
+  const size_t j0 = j + shift->dj;
+  const double wx = shift->wx;
+  const double wy = shift->wy;
+  return
+    + (1. - wy) * (1. - wx) * phi[j0    ][i0    ]
+    + (1. - wy) * (     wx) * phi[j0    ][i0 + 1]
+    + (     wy) * (1. - wx) * phi[j0 + 1][i0    ]
+    + (     wy) * (     wx) * phi[j0 + 1][i0 + 1];
+}
+
+// trace the characteristic passing (x, y) back (midpoint rule),
+//   where (cx, cy) are the time-step size normalised by the grid spacings
+//   and (u, v) is the velocity at the starting point
+static inline void backtrace(
+    const semi_lagrangian_layout_t * const layout_ux,
+    const semi_lagrangian_layout_t * const layout_uy,
+    real_t ** const ux,
+    real_t ** const uy,
+    const double cx,
+    const double cy,
+    const double u,
+    const double v,
+    double * const x,
+    double * const y
+) {
+  const double xm = *x - 0.5 * cx * u;
+  const double ym = *y - 0.5 * cy * v;
+  *x -= cx * interpolate(layout_ux, ux, xm, ym, NULL, NULL);
+  *y -= cy * interpolate(layout_uy, uy, xm, ym, NULL, NULL);
+}
+
+// advect "phi" by the velocity field (ux, uy) over "dt"
+//   using the MacCormack-corrected semi-Lagrangian scheme (Selle et al., 2008)
+//   and add the change to "dphi":
+//     phi_hat   = phi advected forward
+//     phi_check = phi_hat advected backward
+//     new value = phi_hat + (phi - phi_check) / 2,
+//   which is clamped by the extrema of the stencil used to find phi_hat
+// NOTE: "buf" is used to store phi_hat
+int semi_lagrangian_advect(
+    const domain_t * const domain,
+    const semi_lagrangian_layout_t * const layout,
+    real_t ** const ux,
+    real_t ** const uy,
+    const double dt,
+    real_t ** const phi,
+    real_t ** const buf,
+    real_t ** const dphi
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double cx = dt / DOMAIN_DX(domain);
+  // NOTE: uniform grid spacing in y is assumed, see flow_solver_init
+  const double cy = dt / domain->dyf[1];
+  const size_t imin = layout->imin;
+  const size_t jmin = layout->jmin;
+  const semi_lagrangian_layout_t layout_ux = semi_lagrangian_layout_ux(domain);
+  const semi_lagrangian_layout_t layout_uy = semi_lagrangian_layout_uy(domain);
+  const shift_t shift_ux = find_shift(&layout_ux, layout);
+  const shift_t shift_uy = find_shift(&layout_uy, layout);
+  // boundary values are not advected and kept as they are
+#pragma omp parallel for
+  for (size_t j = 0; j <= ny + 1; j++) {
+    for (size_t i = 0; i <= nx + 1; i++) {
+      buf[j][i] = phi[j][i];
+    }
+  }
+  // forward
+#pragma omp parallel for
+  for (size_t j = jmin; j <= ny; j++) {
+    for (size_t i = imin; i <= nx; i++) {
+      double x = i - layout->xoffset;
+      double y = j - layout->yoffset;
+      const double u = interpolate_at_node(&shift_ux, ux, i, j);
+      const double v = interpolate_at_node(&shift_uy, uy, i, j);
+      backtrace(&layout_ux, &layout_uy, ux, uy, cx, cy, u, v, &x, &y);
+      buf[j][i] = interpolate(layout, phi, x, y, NULL, NULL);
+    }
+  }
+  // backward and correction
+#pragma omp parallel for
+  for (size_t j = jmin; j <= ny; j++) {
+    for (size_t i = imin; i <= nx; i++) {
+      const double x = i - layout->xoffset;
+      const double y = j - layout->yoffset;
+      const double u = interpolate_at_node(&shift_ux, ux, i, j);
+      const double v = interpolate_at_node(&shift_uy, uy, i, j);
+      double xb = x;
+      double yb = y;
+      double xf = x;
+      double yf = y;
+      backtrace(&layout_ux, &layout_uy, ux, uy, + cx, + cy, u, v, &xb, &yb);
+      backtrace(&layout_ux, &layout_uy, ux, uy, - cx, - cy, u, v, &xf, &yf);
+      double min = 0.;
+      double max = 0.;
+      interpolate(layout, phi, xb, yb, &min, &max);
+      const double phi_check = interpolate(layout, buf, xf, yf, NULL, NULL);
+      const double value = buf[j][i] + 0.5 * (phi[j][i] - phi_check);
+      dphi[j][i] += min2(max2(value, min), max) - phi[j][i];
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,43 @@
+#if !defined(SEMI_LAGRANGIAN_H)
+#define SEMI_LAGRANGIAN_H
+
+#include <stddef.h> // size_t
+#include "domain.h"
+#include "real.h"
+
+// location of a staggered variable:
+//   [j][i] is located at x = (i - xoffset) * dx, y = (j - yoffset) * dy
+//   (only uniform grids are supported),
+//   [jlo:jhi][ilo:ihi] are referred to by interpolations,
+//   and [jmin:ny][imin:nx] are advected
+typedef struct {
+  double xoffset;
+  double yoffset;
+  size_t ilo;
+  size_t ihi;
+  size_t jlo;
+  size_t jhi;
+  size_t imin;
+  size_t jmin;
+} semi_lagrangian_layout_t;
+
+extern semi_lagrangian_layout_t semi_lagrangian_layout_ux(
+    const domain_t * const domain
+);
+
+extern semi_lagrangian_layout_t semi_lagrangian_layout_uy(
+    const domain_t * const domain
+);
+
+extern int semi_lagrangian_advect(
+    const domain_t * const domain,
+    const semi_lagrangian_layout_t * const layout,
+    real_t ** const ux,
+    real_t ** const uy,
+    const double dt,
+    real_t ** const phi,
+    real_t ** const buf,
+    real_t ** const dphi
+);
+
+#endif // SEMI_LAGRANGIAN_H
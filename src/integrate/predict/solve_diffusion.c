@@ -0,0 +1,124 @@
+#include "param.h"
+#include "tridiagonal_solver.h"
+#include "./solve_diffusion.h"
+#include "../transpose.h"
+
+// Crank-Nicolson treatment of the diffusive terms in the delta form,
+//   whose operator is approximately factorised (ADI):
+//   (1 - a Lx) (1 - a Ly) ddu = du, a = dt / Re / 2,
+//   where du is the explicit increment (including the full diffusive terms)
+// NOTE: each one-dimensional system is solved as (L - 1 / a) x = - b / a,
+//       and the two scalings (- 1 / a) are applied at once when gathering
+static int solve(
+    const size_t imin,
+    const size_t imax,
+    const size_t jmin,
+    const size_t jmax,
+    const double dt,
+    diffusion_system_t * const system_x,
+    diffusion_system_t * const system_y,
+    solver_real_t * const buf0,
+    solver_real_t * const buf1,
+    real_t ** const du
+) {
+  const size_t nitems_x = imax + 1 - imin;
+  const size_t nitems_y = jmax + 1 - jmin;
+  const double a = 0.5 * dt / Re;
+  const double factor = 1. / a / a;
+#pragma omp parallel for
+  for (size_t j = jmin; j <= jmax; j++) {
+    for (size_t i = imin; i <= imax; i++) {
+      buf0[(j - jmin) * nitems_x + (i - imin)] = factor * du[j][i];
+    }
+  }
+  // solve linear systems in x
+  for (size_t j = 0; j < nitems_y; j++) {
+    system_x->tridiagonal_solver_c_offsets[j] = - 1. / a;
+  }
+  if (0 != tridiagonal_solver_exec(
+        system_x->tridiagonal_solver_plan,
+        system_x->tridiagonal_solver_l,
+        system_x->tridiagonal_solver_c,
+        system_x->tridiagonal_solver_u,
+        system_x->tridiagonal_solver_c_offsets,
+        buf0
+  )) {
+    goto abort;
+  }
+  // x-align to y-align
+  if (0 != transpose(nitems_x, nitems_y, buf0, buf1)) {
+    goto abort;
+  }
+  // solve linear systems in y
+  for (size_t i = 0; i < nitems_x; i++) {
+    system_y->tridiagonal_solver_c_offsets[i] = - 1. / a;
+  }
+  if (0 != tridiagonal_solver_exec(
+        system_y->tridiagonal_solver_plan,
+        system_y->tridiagonal_solver_l,
+        system_y->tridiagonal_solver_c,
+        system_y->tridiagonal_solver_u,
+        system_y->tridiagonal_solver_c_offsets,
+        buf1
+  )) {
+    goto abort;
+  }
+  // y-align to x-align
+  if (0 != transpose(nitems_y, nitems_x, buf1, buf0)) {
+    goto abort;
+  }
+#pragma omp parallel for
+  for (size_t j = jmin; j <= jmax; j++) {
+    for (size_t i = imin; i <= imax; i++) {
+      du[j][i] = buf0[(j - jmin) * nitems_x + (i - imin)];
+    }
+  }
+  return 0;
+abort:
+  return 1;
+}
+
+int solve_diffusion_ux(
+    const domain_t * const domain,
+    flow_solver_t * const flow_solver,
+    const double dt,
+    real_t ** const dux
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
+  diffusion_solver_t * const diffusion_solver = &flow_solver->diffusion_solver;
+  return solve(
+      ux_imin, nx,
+            1, ny,
+      dt,
+      &diffusion_solver->ux_x,
+      &diffusion_solver->ux_y,
+      poisson_solver->buf0,
+      poisson_solver->buf1,
+      dux
+  );
+}
+
+int solve_diffusion_uy(
+    const domain_t * const domain,
+    flow_solver_t * const flow_solver,
+    const double dt,
+    real_t ** const duy
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
+  diffusion_solver_t * const diffusion_solver = &flow_solver->diffusion_solver;
+  return solve(
+            1, nx,
+      uy_jmin, ny,
+      dt,
+      &diffusion_solver->uy_x,
+      &diffusion_solver->uy_y,
+      poisson_solver->buf0,
+      poisson_solver->buf1,
+      duy
+  );
+}
+
@@ -0,0 +1,22 @@
+#if !defined(SOLVE_DIFFUSION_H)
+#define SOLVE_DIFFUSION_H
+
+#include "domain.h"
+#include "real.h"
+#include "flow_solver.h"
+
+int solve_diffusion_ux(
+    const domain_t * const domain,
+    flow_solver_t * const flow_solver,
+    const double dt,
+    real_t ** const dux
+);
+
+int solve_diffusion_uy(
+    const domain_t * const domain,
+    flow_solver_t * const flow_solver,
+    const double dt,
+    real_t ** const duy
+);
+
+#endif // SOLVE_DIFFUSION_H
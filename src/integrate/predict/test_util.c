@@ -37,14 +37,13 @@ double get_p(
 
 int get_array_ux(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   const double dx = domain->dx;
-  const double dy = domain->dy;
   for (size_t j = 1; j <= ny; j++) {
-    const double y = 0.5 * (2 * j - 1) * dy;
+    const double y = domain->yc[j];
     for (size_t i = 1; i <= nx; i++) {
       const double x = 0.5 * (2 * i - 2) * dx;
       ux[j][i] = get_ux(domain, x, y);
@@ -63,14 +62,13 @@ int get_array_ux(
 
 int get_array_uy(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   const double dx = domain->dx;
-  const double dy = domain->dy;
   for (size_t j = 1; j <= ny; j++) {
-    const double y = 0.5 * (2 * j - 2) * dy;
+    const double y = domain->yf[j];
     for (size_t i = 1; i <= nx; i++) {
       const double x = 0.5 * (2 * i - 1) * dx;
       uy[j][i] = get_uy(domain, x, y);
@@ -89,14 +87,13 @@ int get_array_uy(
 
 int get_array_p(
     const domain_t * const domain,
-    double ** const p
+    real_t ** const p
 ) {
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   const double dx = domain->dx;
-  const double dy = domain->dy;
   for (size_t j = 1; j <= ny; j++) {
-    const double y = 0.5 * (2 * j - 1) * dy;
+    const double y = domain->yc[j];
     for (size_t i = 1; i <= nx; i++) {
       const double x = 0.5 * (2 * i - 1) * dx;
       p[j][i] = get_p(domain, x, y);
@@ -115,8 +112,8 @@ int get_array_p(
 
 int check_error(
     const domain_t * const domain,
-    double ** const answer,
-    double ** const result,
+    real_t ** const answer,
+    real_t ** const result,
     double * const error
 ) {
   const size_t nx = domain->nx;
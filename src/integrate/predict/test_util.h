@@ -2,6 +2,7 @@
 #define TEST_UTIL_H
 
 #include "domain.h"
+#include "real.h"
 
 extern double get_ux(
     const domain_t * const domain,
@@ -23,23 +24,23 @@ extern double get_p(
 
 extern int get_array_ux(
     const domain_t * const domain,
-    double ** const ux
+    real_t ** const ux
 );
 
 extern int get_array_uy(
     const domain_t * const domain,
-    double ** const uy
+    real_t ** const uy
 );
 
 extern int get_array_p(
     const domain_t * const domain,
-    double ** const p
+    real_t ** const p
 );
 
 extern int check_error(
     const domain_t * const domain,
-    double ** const answer,
-    double ** const result,
+    real_t ** const answer,
+    real_t ** const result,
     double * const error
 );
 
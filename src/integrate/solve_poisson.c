@@ -1,4 +1,7 @@
+#include <stdbool.h> // bool, true, false
+#include <math.h> // fabs
 #include "logger.h"
+#include "array.h"
 #include "dft/rdft.h"
 #include "dft/dct.h"
 #include "tridiagonal_solver.h"
@@ -6,40 +9,94 @@
 #include "./solve_poisson.h"
 #include "./transpose.h"
 
-int solve_poisson(
+// iterative refinement, used when the Poisson equation is solved
+//   in lower precision than the flow fields (PRECISION=refined, see include/real.h):
+//   after the first solve, the residual is evaluated in real_t and the correction is solved again
+//   in at most "max_nsweeps" sweeps (i.e., at most 1 + max_nsweeps solves),
+//   which stop once the maximum divergence after the projection (div_max in monitor.c)
+//   falls below "tolerance" times the one before the projection
+// NOTE: each sweep reduces the divergence by four to five orders of magnitude,
+//       so that the tolerance is reached by the last sweep
+static const bool refine = sizeof(solver_real_t) < sizeof(real_t);
+static const size_t max_nsweeps = 2;
+static const double tolerance = 1.e-9;
+
+// discrete Laplacian of psi at the cell center [j][i],
+//   which is consistent with the linear systems and the correction (correct.c),
+//   i.e., the fluxes through the walls vanish
+static double laplacian(
     const domain_t * const domain,
-    flow_field_t * const flow_field,
-    flow_solver_t * const flow_solver,
-    const double dt
+    const size_t pitch,
+    const real_t * restrict const psi,
+    const size_t j,
+    const size_t i
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  const double dx = domain->dx;
-  const double dy = domain->dy;
-  poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
-  double ** const psi = flow_solver->psi;
-  double * const buf0 = poisson_solver->buf0;
-  double * const buf1 = poisson_solver->buf1;
-  // assign right-hand side of Poisson equation
-  {
-    double ** const ux = flow_field->ux;
-    double ** const uy = flow_field->uy;
-    const double factor = 1. / dt / poisson_solver->dft_norm;
-#pragma omp parallel for
-    for (size_t j = 1; j <= ny; j++) {
-      for (size_t i = 1; i <= nx; i++) {
-        const double dux = - ux[j    ][i    ]
-                           + ux[j    ][i + 1];
-        const double duy = - uy[j    ][i    ]
-                           + uy[j + 1][i    ];
-        const double div = (
-            + 1. / dx * dux
-            + 1. / dy * duy
-        );
-        buf0[(j - 1) * nx + (i - 1)] = factor * div;
-      }
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double dx = DOMAIN_DX(domain);
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
+  const double dpsidx_m = !X_PERIODIC &&  1 == i ? 0. : (- psi[(j    ) * pitch + (i - 1)] + psi[(j    ) * pitch + (i    )]) / dx;
+  const double dpsidx_p = !X_PERIODIC && nx == i ? 0. : (- psi[(j    ) * pitch + (i    )] + psi[(j    ) * pitch + (i + 1)]) / dx;
+  const double dpsidy_m = !Y_PERIODIC &&  1 == j ? 0. : (- psi[(j - 1) * pitch + (i    )] + psi[(j    ) * pitch + (i    )]) / dyc[j    ];
+  const double dpsidy_p = !Y_PERIODIC && ny == j ? 0. : (- psi[(j    ) * pitch + (i    )] + psi[(j + 1) * pitch + (i    )]) / dyc[j + 1];
+  return
+    + (- dpsidx_m + dpsidx_p) / dx
+    + (- dpsidy_m + dpsidy_p) / dyf[j];
+}
+
+// assign right-hand side of Poisson equation, div(u) / dt - L(psi),
+//   to buf0 (x-aligned, normalised for the transforms),
+//   and return the maximum divergence after the projection with the current psi
+// NOTE: psi is referred to only when "has_psi" is true
+static double assign_rhs(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const poisson_solver_t * const poisson_solver,
+    real_t ** const psi,
+    const bool has_psi,
+    const double dt,
+    solver_real_t * const buf0
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  const double dx = DOMAIN_DX(domain);
+  const double * const dyf = domain->dyf;
+  const size_t pitch = array_view(flow_field->ux).pitch;
+  const real_t * restrict const ux = ARRAY_ASSUME_ALIGNED(array_view(flow_field->ux).data);
+  const real_t * restrict const uy = ARRAY_ASSUME_ALIGNED(array_view(flow_field->uy).data);
+  const real_t * restrict const psi_ = ARRAY_ASSUME_ALIGNED(array_view(psi).data);
+  const double factor = 1. / dt / poisson_solver->dft_norm;
+  double divergence = 0.;
+#pragma omp parallel for reduction(max: divergence)
+  for (size_t j = 1; j <= ny; j++) {
+    const double dy = dyf[j];
+    for (size_t i = 1; i <= nx; i++) {
+      const double dux = - ux[(j    ) * pitch + (i    )]
+                         + ux[(j    ) * pitch + (i + 1)];
+      const double duy = - uy[(j    ) * pitch + (i    )]
+                         + uy[(j + 1) * pitch + (i    )];
+      const double div = (
+          + 1. / dx * dux
+          + 1. / dy * duy
+      ) - (has_psi ? dt * laplacian(domain, pitch, psi_, j, i) : 0.);
+      buf0[(j - 1) * nx + (i - 1)] = factor * div;
+      divergence = fmax(divergence, fabs(div));
     }
   }
+  return divergence;
+}
+
+// solve the Poisson equation whose right-hand side is given in buf0,
+//   and store the answer in buf0
+static int solve(
+    const domain_t * const domain,
+    poisson_solver_t * const poisson_solver
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  solver_real_t * const buf0 = poisson_solver->buf0;
+  solver_real_t * const buf1 = poisson_solver->buf1;
   // project x to wave space
   if (X_PERIODIC) {
     rdft_plan_t * const rdft_plan = poisson_solver->rdft_plan;
@@ -62,10 +119,10 @@ int solve_poisson(
   // solve linear systems in y
   {
     tridiagonal_solver_plan_t * const tridiagonal_solver_plan = poisson_solver->tridiagonal_solver_plan;
-    const double * const tridiagonal_solver_l = poisson_solver->tridiagonal_solver_l;
-    const double * const tridiagonal_solver_c = poisson_solver->tridiagonal_solver_c;
-    const double * const tridiagonal_solver_u = poisson_solver->tridiagonal_solver_u;
-    const double * const wavenumbers = poisson_solver->wavenumbers;
+    const solver_real_t * const tridiagonal_solver_l = poisson_solver->tridiagonal_solver_l;
+    const solver_real_t * const tridiagonal_solver_c = poisson_solver->tridiagonal_solver_c;
+    const solver_real_t * const tridiagonal_solver_u = poisson_solver->tridiagonal_solver_u;
+    const solver_real_t * const wavenumbers = poisson_solver->wavenumbers;
     if (0 != tridiagonal_solver_exec(tridiagonal_solver_plan, tridiagonal_solver_l, tridiagonal_solver_c, tridiagonal_solver_u, wavenumbers, buf1)) {
       LOGGER_FAILURE("failed to solve tri-diagonal matrix");
       goto abort;
@@ -90,10 +147,29 @@ int solve_poisson(
       goto abort;
     }
   }
+  return 0;
+abort:
+  return 1;
+}
+
+// assign (or add, when "is_correction" is true) the answer in buf0 to psi
+static int update_psi(
+    const domain_t * const domain,
+    const solver_real_t * const buf0,
+    const bool is_correction,
+    real_t ** const psi
+) {
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  {
+    const size_t pitch = array_view(psi).pitch;
+    real_t * restrict const psi_ = ARRAY_ASSUME_ALIGNED(array_view(psi).data);
 #pragma omp parallel for
-  for (size_t j = 1; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      psi[j][i] = buf0[(j - 1) * nx + (i - 1)];
+    for (size_t j = 1; j <= ny; j++) {
+      for (size_t i = 1; i <= nx; i++) {
+        const real_t value = buf0[(j - 1) * nx + (i - 1)];
+        psi_[j * pitch + i] = is_correction ? psi_[j * pitch + i] + value : value;
+      }
     }
   }
   // exchange halo
@@ -116,3 +192,34 @@ abort:
   return 1;
 }
 
+int solve_poisson(
+    const domain_t * const domain,
+    flow_field_t * const flow_field,
+    flow_solver_t * const flow_solver,
+    const double dt
+) {
+  poisson_solver_t * const poisson_solver = &flow_solver->poisson_solver;
+  real_t ** const psi = flow_solver->psi;
+  const double divergence = assign_rhs(domain, flow_field, poisson_solver, psi, false, dt, poisson_solver->buf0);
+  // "nsweeps" is the number of refinement sweeps preceding this solve
+  for (size_t nsweeps = 0; ; nsweeps++) {
+    if (0 != solve(domain, poisson_solver)) {
+      LOGGER_FAILURE("failed to solve Poisson equation");
+      goto abort;
+    }
+    if (0 != update_psi(domain, poisson_solver->buf0, 0 != nsweeps, psi)) {
+      LOGGER_FAILURE("failed to update scalar potential");
+      goto abort;
+    }
+    if (!refine || max_nsweeps == nsweeps) {
+      break;
+    }
+    if (assign_rhs(domain, flow_field, poisson_solver, psi, true, dt, poisson_solver->buf0) < tolerance * divergence) {
+      break;
+    }
+  }
+  return 0;
+abort:
+  return 1;
+}
+
@@ -2,12 +2,13 @@
 #define TRANSPOSE_H
 
 #include <stddef.h> // size_t
+#include "real.h" // solver_real_t
 
 extern int transpose(
     const size_t nx,
     const size_t ny,
-    const double * const buf0,
-    double * const buf11
+    const solver_real_t * const buf0,
+    solver_real_t * const buf11
 );
 
 #endif // TRANSPOSE_H
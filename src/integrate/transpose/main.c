@@ -3,8 +3,8 @@
 int transpose(
     const size_t nx,
     const size_t ny,
-    const double * const buf0,
-    double * const buf1
+    const solver_real_t * const buf0,
+    solver_real_t * const buf1
 ) {
 #pragma omp parallel for
   for (size_t j = 0; j < ny; j++) {
@@ -7,10 +7,10 @@ int update_pressure(
     flow_field_t * const flow_field,
     flow_solver_t * const flow_solver
 ) {
-  const size_t nx = domain->nx;
-  const size_t ny = domain->ny;
-  double ** const psi = flow_solver->psi;
-  double ** const p = flow_field->p;
+  const size_t nx = DOMAIN_NX(domain);
+  const size_t ny = DOMAIN_NY(domain);
+  real_t ** const psi = flow_solver->psi;
+  real_t ** const p = flow_field->p;
 #pragma omp parallel for
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
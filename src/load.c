@@ -0,0 +1,347 @@
+// fileno
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // FILE, fopen, fclose, fileno, snprintf
+#include <stdlib.h> // free
+#include <stdbool.h> // bool
+#include <string.h> // strlen, strcmp, memcpy
+#include <errno.h> // errno
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // stat, fstat
+#include "memory.h"
+#include "logger.h"
+#include "domain.h"
+#include "real.h"
+#include "flow_field.h"
+#include "statistics.h"
+#include "./load.h"
+#include "./save/snpyio.h"
+
+#define NDIMS 2
+
+// data type accepted for a data set and the size of its element
+typedef struct {
+  const char * name;
+  size_t size;
+} dtype_t;
+
+// NPY file whose content is mapped onto memory
+typedef struct {
+  void * addr;
+  size_t length;
+  // size of an element of the data set, given by its data type
+  size_t size;
+  // beginning of the data set (after NPY header)
+  const void * payload;
+} npy_map_t;
+
+static int concat_file_name(
+    const char dir_name[],
+    const char dset_name[],
+    char ** const file_name
+){
+  const char slash[] = {"/"};
+  const char suffix[] = {".npy"};
+  const int nchars =
+    + strlen( dir_name)
+    + strlen(    slash)
+    + strlen(dset_name)
+    + strlen(   suffix)
+    + 1;
+  *file_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
+  (*file_name)[nchars - 1] = '\0';
+  if (nchars - 1 != snprintf(*file_name, nchars, "%s%s%s%s", dir_name, slash, dset_name, suffix)) {
+    LOGGER_FAILURE("snprintf returns unexpected result");
+    goto abort;
+  }
+  return 0;
+abort:
+  return 1;
+}
+
+// check NPY header and map the whole file onto memory (read-only),
+//   so that the data set is read directly from the page cache
+// NOTE: the data type should be one of "dtypes"
+static int map_npy_file(
+    const char dir_name[],
+    const char dset_name[],
+    const size_t ndims,
+    const size_t * shape,
+    const size_t ndtypes,
+    const dtype_t * dtypes,
+    npy_map_t * const npy_map
+){
+  int error_code = 0;
+  char * file_name = NULL;
+  FILE * fp = NULL;
+  size_t ndims_ = 0;
+  size_t * shape_ = NULL;
+  char * dtype_ = NULL;
+  bool is_fortran_order = false;
+  size_t header_size = 0;
+  if (0 != concat_file_name(dir_name, dset_name, &file_name)) {
+    error_code = 1;
+    goto abort;
+  }
+  errno = 0;
+  fp = fopen(file_name, "r");
+  if (NULL == fp) {
+    perror(file_name);
+    error_code = 1;
+    LOGGER_FAILURE("failed to open file (attempted to read NPY header)");
+    goto abort;
+  }
+  if (0 != snpyio_r_header(&ndims_, &shape_, &dtype_, &is_fortran_order, fp, &header_size)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to read NPY header");
+    goto abort;
+  }
+  // compare with the expected properties
+  size_t size = 0;
+  for (size_t n = 0; n < ndtypes; n++) {
+    if (0 == strcmp(dtypes[n].name, dtype_)) {
+      size = dtypes[n].size;
+    }
+  }
+  {
+    bool is_consistent = ndims == ndims_ && 0 != size && !is_fortran_order;
+    for (size_t dim = 0; is_consistent && dim < ndims; dim++) {
+      is_consistent = shape[dim] == shape_[dim];
+    }
+    if (!is_consistent) {
+      fprintf(stderr, "%s: unexpected data set (%s, %zu dimension(s))\n", file_name, dtype_, ndims_);
+      error_code = 1;
+      LOGGER_FAILURE("only uncompressed data sets including halo cells can be loaded");
+      goto abort;
+    }
+  }
+  size_t nitems = 1;
+  for (size_t dim = 0; dim < ndims; dim++) {
+    nitems *= shape[dim];
+  }
+  struct stat file_stat = {0};
+  if (0 != fstat(fileno(fp), &file_stat) || (size_t)file_stat.st_size < header_size + nitems * size) {
+    error_code = 1;
+    LOGGER_FAILURE("file is smaller than expected");
+    goto abort;
+  }
+  npy_map->length = (size_t)file_stat.st_size;
+  npy_map->addr = mmap(NULL, npy_map->length, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+  if (MAP_FAILED == npy_map->addr) {
+    perror(file_name);
+    npy_map->addr = NULL;
+    error_code = 1;
+    LOGGER_FAILURE("failed to map file onto memory");
+    goto abort;
+  }
+  npy_map->size = size;
+  npy_map->payload = (const char *)npy_map->addr + header_size;
+abort:
+  memory_free(file_name);
+  // NOTE: allocated by snpyio_r_header
+  free(shape_);
+  free(dtype_);
+  // NOTE: mapping remains valid after the file is closed
+  if (NULL != fp) {
+    fclose(fp);
+  }
+  return error_code;
+}
+
+static int unmap_npy_file(
+    npy_map_t * const npy_map
+){
+  if (0 != munmap(npy_map->addr, npy_map->length)) {
+    LOGGER_FAILURE("failed to unmap file");
+    return 1;
+  }
+  npy_map->addr = NULL;
+  return 0;
+}
+
+static int load_scalar(
+    const char dir_name[],
+    const char dset_name[],
+    const char dtype[],
+    const size_t size,
+    void * const value
+){
+  npy_map_t npy_map = {0};
+  if (0 != map_npy_file(dir_name, dset_name, 0, NULL, 1, &(dtype_t){.name = dtype, .size = size}, &npy_map)) {
+    return 1;
+  }
+  memcpy(value, npy_map.payload, size);
+  return unmap_npy_file(&npy_map);
+}
+
+// load a whole array (including halo cells) stored in double or single precision
+//   (checkpoints are always in double, while snapshots follow PRECISION),
+//   which is converted to real_t when the two differ
+static int load_field(
+    const char dir_name[],
+    const char dset_name[],
+    const domain_t * const domain,
+    real_t ** const array
+){
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  const size_t shape[NDIMS] = {ny + 2, nx + 2};
+  const dtype_t dtypes[] = {
+    {.name = "'<f8'", .size = sizeof(double)},
+    {.name = "'<f4'", .size = sizeof(float )},
+  };
+  npy_map_t npy_map = {0};
+  if (0 != map_npy_file(dir_name, dset_name, NDIMS, shape, sizeof(dtypes) / sizeof(dtypes[0]), dtypes, &npy_map)) {
+    return 1;
+  }
+  // copy rows from the mapping to the field in parallel
+  if (sizeof(real_t) == npy_map.size) {
+    const char * const payload = npy_map.payload;
+    const size_t row_size = shape[1] * sizeof(real_t);
+#pragma omp parallel for
+    for (size_t j = 0; j < shape[0]; j++) {
+      memcpy(array[j], payload + j * row_size, row_size);
+    }
+  } else if (sizeof(double) == npy_map.size) {
+    const double * const payload = npy_map.payload;
+#pragma omp parallel for
+    for (size_t j = 0; j < shape[0]; j++) {
+      for (size_t i = 0; i < shape[1]; i++) {
+        array[j][i] = payload[j * shape[1] + i];
+      }
+    }
+  } else {
+    const float * const payload = npy_map.payload;
+#pragma omp parallel for
+    for (size_t j = 0; j < shape[0]; j++) {
+      for (size_t i = 0; i < shape[1]; i++) {
+        array[j][i] = payload[j * shape[1] + i];
+      }
+    }
+  }
+  return unmap_npy_file(&npy_map);
+}
+
+static bool exists_npy_file(
+    const char dir_name[],
+    const char dset_name[]
+){
+  char * file_name = NULL;
+  if (0 != concat_file_name(dir_name, dset_name, &file_name)) {
+    memory_free(file_name);
+    return false;
+  }
+  struct stat file_stat = {0};
+  const bool exists = 0 == stat(file_name, &file_stat);
+  memory_free(file_name);
+  return exists;
+}
+
+// statistics are restored only when they are stored (i.e., checkpoints),
+//   otherwise the accumulation starts from scratch
+static int load_statistics(
+    const char dir_name[],
+    const domain_t * const domain,
+    statistics_t * const statistics
+){
+  if (!exists_npy_file(dir_name, "stat_nsamples")) {
+    return 0;
+  }
+  if (0 != load_scalar(dir_name, "stat_nsamples", "'<u8'", sizeof(size_t), &statistics->nsamples)) {
+    return 1;
+  }
+  const struct {
+    const char * name;
+    real_t ** array;
+  } fields[] = {
+    {.name = "stat_ux_mean",  .array = statistics->ux_mean },
+    {.name = "stat_ux_m2",    .array = statistics->ux_m2   },
+    {.name = "stat_uy_mean",  .array = statistics->uy_mean },
+    {.name = "stat_uy_m2",    .array = statistics->uy_m2   },
+    {.name = "stat_p_mean",   .array = statistics-> p_mean },
+    {.name = "stat_p_m2",     .array = statistics-> p_m2   },
+    {.name = "stat_uxc_mean", .array = statistics->uxc_mean},
+    {.name = "stat_uyc_mean", .array = statistics->uyc_mean},
+    {.name = "stat_uxuy_m2",  .array = statistics->uxuy_m2 },
+  };
+  for (size_t n = 0; n < sizeof(fields) / sizeof(fields[0]); n++) {
+    if (0 != load_field(dir_name, fields[n].name, domain, fields[n].array)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// the state of the body is restored only when it is stored (i.e., checkpoints),
+//   otherwise the body stays at the initial position
+static int load_body(
+    const char dir_name[],
+    const domain_t * const domain,
+    flow_field_t * const flow_field
+){
+  if (!exists_npy_file(dir_name, "body_center")) {
+    return 0;
+  }
+  body_t * const body = &flow_field->body;
+  const size_t shape[1] = {2};
+  const struct {
+    const char * name;
+    double * vector;
+  } vectors[] = {
+    {.name = "body_center",   .vector = body->center  },
+    {.name = "body_velocity", .vector = body->velocity},
+  };
+  for (size_t n = 0; n < sizeof(vectors) / sizeof(vectors[0]); n++) {
+    npy_map_t npy_map = {0};
+    if (0 != map_npy_file(dir_name, vectors[n].name, 1, shape, 1, &(dtype_t){.name = "'<f8'", .size = sizeof(double)}, &npy_map)) {
+      return 1;
+    }
+    memcpy(vectors[n].vector, npy_map.payload, shape[0] * sizeof(double));
+    if (0 != unmap_npy_file(&npy_map)) {
+      return 1;
+    }
+  }
+  return flow_field_place_body(domain, flow_field);
+}
+
+int load(
+    const char dir_name[],
+    size_t * const step,
+    double * const time,
+    const domain_t * const domain,
+    flow_field_t * const flow_field,
+    statistics_t * const statistics
+) {
+  if (0 != load_scalar(dir_name, "step", "'<u8'", sizeof(size_t), step)) {
+    LOGGER_FAILURE("failed to load step");
+    goto abort;
+  }
+  if (0 != load_scalar(dir_name, "time", "'<f8'", sizeof(double), time)) {
+    LOGGER_FAILURE("failed to load time");
+    goto abort;
+  }
+  if (0 != load_field(dir_name, "ux", domain, flow_field->ux)) {
+    LOGGER_FAILURE("failed to load ux");
+    goto abort;
+  }
+  if (0 != load_field(dir_name, "uy", domain, flow_field->uy)) {
+    LOGGER_FAILURE("failed to load uy");
+    goto abort;
+  }
+  if (0 != load_field(dir_name, "p", domain, flow_field->p)) {
+    LOGGER_FAILURE("failed to load p");
+    goto abort;
+  }
+  if (0 != load_body(dir_name, domain, flow_field)) {
+    LOGGER_FAILURE("failed to load body");
+    goto abort;
+  }
+  if (0 != load_statistics(dir_name, domain, statistics)) {
+    LOGGER_FAILURE("failed to load statistics");
+    goto abort;
+  }
+  return 0;
+abort:
+  LOGGER_FAILURE("failed to load flow field");
+  return 1;
+}
@@ -0,0 +1,18 @@
+#if !defined(LOAD_H)
+#define LOAD_H
+
+#include <stddef.h> // size_t
+#include "domain.h" // domain_t
+#include "flow_field.h" // flow_field_t
+#include "statistics.h" // statistics_t
+
+extern int load(
+    const char dir_name[],
+    size_t * const step,
+    double * const time,
+    const domain_t * const domain,
+    flow_field_t * const flow_field,
+    statistics_t * const statistics
+);
+
+#endif // LOAD_H
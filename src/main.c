@@ -1,22 +1,48 @@
+#include <stdio.h> // printf, fflush, setvbuf, stdout, BUFSIZ, _IOFBF
 #include <stddef.h> // size_t
+#include <math.h> // floor
+#include <time.h> // time_t, time, difftime
+#include "memory.h"
 #include "domain.h"
 #include "flow_field.h"
 #include "flow_solver.h"
+#include "statistics.h"
+#include "simd.h"
 #include "./integrate.h"
 #include "./monitor.h"
 #include "./save.h"
+#include "./load.h"
+#include "./telemetry.h"
 
 typedef struct {
   double monitor;
   double save;
 } schedule_t;
 
+// elapsed wall-clock time in seconds
+static double get_wall_time(
+    const time_t start
+) {
+  return difftime(time(NULL), start);
+}
+
+// usage:
+//   ./a.out            : start from the initial condition
+//   ./a.out directory  : restart from a checkpoint (or a snapshot including halo cells)
 int main(
-    void
+    int argc,
+    char * argv[]
 ) {
+  // NOTE: the standard output is fully buffered and flushed explicitly,
+  //       which has to be configured before anything is written to it
+  if (0 != setvbuf(stdout, NULL, _IOFBF, BUFSIZ)) {
+    return 1;
+  }
+  const time_t wall_time_start = time(NULL);
   domain_t domain = {};
   flow_field_t flow_field = {};
   flow_solver_t flow_solver = {};
+  statistics_t statistics = {};
   if (0 != domain_init(&domain)) {
     return 1;
   }
@@ -26,30 +52,126 @@ int main(
   if (0 != flow_solver_init(&domain, &flow_solver)) {
     return 1;
   }
+  if (0 != statistics_init(&domain, &statistics)) {
+    return 1;
+  }
+  if (0 != monitor_init(&domain)) {
+    return 1;
+  }
+  // NOTE: the simulation continues without telemetry when it is not available
+  telemetry_init();
+  printf("kernels are dispatched to %s\n", simd_isa());
+  if (NULL != telemetry_segment_name()) {
+    printf("telemetry is published to %s\n", telemetry_segment_name());
+  }
+  fflush(stdout);
+  size_t step = 0;
+  double time = 0.;
+  if (2 == argc) {
+    if (0 != load(argv[1], &step, &time, &domain, &flow_field, &statistics)) {
+      return 1;
+    }
+    printf("restart from %s: step %10zu time % .2e\n", argv[1], step, time);
+    fflush(stdout);
+  }
+  // NOTE: the checkpoint from which the simulation is restarted is rotated away
+  if (0 != checkpoint_init(2 == argc ? argv[1] : NULL)) {
+    return 1;
+  }
   const double time_max = 5.e+0;
   const schedule_t rate = {
     .monitor = 1.e-1,
     .save = 2.e-1,
   };
-  schedule_t next = rate;
-  for (double time = 0.; time < time_max; ) {
-    static size_t step = 0;
+  // statistics are collected every "rate" steps after "time_start"
+  const struct {
+    double time_start;
+    size_t rate;
+  } statistics_schedule = {
+    .time_start = 2.5e+0,
+    .rate = 10,
+  };
+  // wall-clock-time limits in seconds:
+  //   checkpoints are written every "checkpoint" seconds
+  //   and when the run is terminated after "max" seconds
+  const struct {
+    double checkpoint;
+    double max;
+  } wall_time = {
+    .checkpoint = 3.6e+3,
+    .max = 8.64e+4,
+  };
+  // resume schedules, which are uniquely determined by the current time
+  schedule_t next = {
+    .monitor = rate.monitor * (1. + floor(time / rate.monitor)),
+    .save    = rate.save    * (1. + floor(time / rate.save   )),
+  };
+  size_t save_id = (size_t)floor(time / rate.save);
+  double next_checkpoint = wall_time.checkpoint;
+  int exit_code = 0;
+  while (time < time_max) {
     double dt = 0.;
-    if (0 != integrate(&domain, &flow_field, &flow_solver, &dt)) {
+    integrate_timings_t timings = {0};
+    if (0 != integrate(&domain, &flow_field, &flow_solver, &dt, &timings)) {
       break;
     }
     step += 1;
     time += dt;
+    flow_field_move_body(&domain, time, dt, &flow_field);
+    telemetry_publish_step(step, time, dt, (double []){
+        timings.decide_dt,
+        timings.predict,
+        timings.solve_poisson,
+        timings.correct,
+        timings.update_pressure,
+    });
+    monitor_probes(step, time, &flow_field);
     if (next.monitor < time) {
       monitor(step, time, dt, &domain, &flow_field);
       next.monitor += rate.monitor;
     }
     if (next.save < time) {
-      static size_t id = 0;
-      save(id, step, time, &domain, &flow_field);
-      id += 1;
+      save(save_id, step, time, &domain, &flow_field);
+      save_id += 1;
       next.save += rate.save;
     }
+    if (statistics_schedule.time_start < time && 0 == step % statistics_schedule.rate) {
+      statistics_update(&domain, &flow_field, &statistics);
+    }
+    const double elapsed = get_wall_time(wall_time_start);
+    if (wall_time.max < elapsed) {
+      printf("wall-clock-time limit is reached: step %10zu time % .2e\n", step, time);
+      fflush(stdout);
+      monitor_flush();
+      // NOTE: without the final checkpoint, the run cannot be continued from here
+      if (0 != checkpoint(step, time, &domain, &flow_field, &statistics)) {
+        printf("failed to write the final checkpoint: step %10zu\n", step);
+        fflush(stdout);
+        exit_code = 1;
+      }
+      break;
+    }
+    if (next_checkpoint < elapsed) {
+      monitor_flush();
+      // NOTE: the simulation continues with the previous checkpoint
+      if (0 != checkpoint(step, time, &domain, &flow_field, &statistics)) {
+        printf("failed to write a checkpoint, the previous one is kept: step %10zu\n", step);
+        fflush(stdout);
+      }
+      next_checkpoint += wall_time.checkpoint;
+    }
+  }
+  if (0 < statistics.nsamples) {
+    save_statistics(step, time, &domain, &statistics);
+  }
+  if (0 != checkpoint_finalize()) {
+    return 1;
+  }
+  if (0 != monitor_finalize()) {
+    return 1;
+  }
+  if (0 != telemetry_finalize()) {
+    return 1;
   }
   if (0 != flow_field_finalize(&flow_field)) {
     return 1;
@@ -57,6 +179,13 @@ int main(
   if (0 != flow_solver_finalize(&flow_solver)) {
     return 1;
   }
-  return 0;
+  if (0 != statistics_finalize(&statistics)) {
+    return 1;
+  }
+  if (0 != domain_finalize(&domain)) {
+    return 1;
+  }
+  memory_report();
+  return exit_code;
 }
 
@@ -1,24 +1,304 @@
-#include <stdio.h> // fprintf, stderr
-#include <stdlib.h> // calloc, free, exit, EXIT_FAILURE
+#include <stdio.h> // printf, fprintf, stderr
+#include <stdlib.h> // malloc, free, exit, EXIT_FAILURE
+#include <stdint.h> // uintptr_t, SIZE_MAX
+#include <stdbool.h> // bool, true, false
+#include <string.h> // memset
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include "memory.h"
 
-void * memory_alloc(
+// all allocations are preceded by a header,
+//   which is used to release the memory and to account for the footprint
+typedef struct {
+  // address returned by malloc, NULL if the memory belongs to an arena
+  void * base;
+  size_t nbytes;
+  memory_tag_t tag;
+} header_t;
+
+// alignment of the memory returned by memory_alloc,
+//   which is sufficient for any built-in type
+static const size_t default_alignment = 16;
+
+static const char * const tag_names[MEMORY_NTAGS] = {
+  "field",
+  "solver",
+  "io",
+  "other",
+};
+
+// footprint in bytes, updated atomically
+//   as memory might be allocated inside parallel regions
+static size_t current[MEMORY_NTAGS] = {0};
+static size_t peak[MEMORY_NTAGS] = {0};
+static size_t current_total = 0;
+static size_t peak_total = 0;
+
+static void update_peak(
+    size_t * const peak_,
+    const size_t value
+) {
+  size_t old = __atomic_load_n(peak_, __ATOMIC_RELAXED);
+  while (old < value && !__atomic_compare_exchange_n(peak_, &old, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+static void account(
+    const memory_tag_t tag,
+    const size_t nbytes,
+    const bool is_alloc
+) {
+  if (is_alloc) {
+    update_peak(&peak[tag], __atomic_add_fetch(&current[tag], nbytes, __ATOMIC_RELAXED));
+    update_peak(&peak_total, __atomic_add_fetch(&current_total, nbytes, __ATOMIC_RELAXED));
+  } else {
+    __atomic_sub_fetch(&current[tag], nbytes, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&current_total, nbytes, __ATOMIC_RELAXED);
+  }
+}
+
+static size_t find_nbytes(
     const size_t nitems,
     const size_t size
 ) {
-  void * const ptr = calloc(nitems, size);
+  if (0 != size && SIZE_MAX / size < nitems) {
+    fprintf(stderr, "size overflow: %zu x %zu\n", nitems, size);
+    exit(EXIT_FAILURE);
+  }
+  return nitems * size;
+}
+
+// the smallest address not less than "ptr + sizeof(header_t)" aligned to "alignment",
+//   leaving a space for the header
+static unsigned char * find_payload(
+    unsigned char * const ptr,
+    const size_t alignment
+) {
+  const uintptr_t address = (uintptr_t)(ptr + sizeof(header_t));
+  return ptr + sizeof(header_t) + (alignment - address % alignment) % alignment;
+}
+
+static void * alloc(
+    const size_t nbytes,
+    const size_t alignment,
+    const memory_tag_t tag
+) {
+  void * const base = malloc(nbytes + sizeof(header_t) + alignment);
+  if (NULL == base) {
+    return NULL;
+  }
+  unsigned char * const payload = find_payload(base, alignment);
+  header_t * const header = (header_t *)payload - 1;
+  header->base = base;
+  header->nbytes = nbytes;
+  header->tag = tag;
+  account(tag, nbytes, true);
+  return payload;
+}
+
+void * memory_alloc(
+    const size_t nitems,
+    const size_t size,
+    const memory_tag_t tag
+) {
+  const size_t nbytes = find_nbytes(nitems, size);
+  void * const ptr = alloc(nbytes, default_alignment, tag);
   if (NULL == ptr) {
     goto abort;
   }
+  memset(ptr, 0, nbytes);
   return ptr;
 abort:
   fprintf(stderr, "failed to allocate memory: %zu x %zu\n", nitems, size);
   exit(EXIT_FAILURE);
 }
 
+// memory whose address is a multiple of "alignment",
+//   which should be a power of two not less than 16
+// NOTE: the memory is not initialised,
+//       so that the pages are placed by memory_first_touch
+// NOTE: released by memory_free as well
+void * memory_alloc_aligned(
+    const size_t nitems,
+    const size_t size,
+    const size_t alignment,
+    const memory_tag_t tag
+) {
+  void * const ptr = alloc(find_nbytes(nitems, size), alignment, tag);
+  if (NULL == ptr) {
+    goto abort;
+  }
+  return ptr;
+abort:
+  fprintf(stderr, "failed to allocate aligned memory: %zu x %zu (%zu)\n", nitems, size, alignment);
+  exit(EXIT_FAILURE);
+}
+
+// zero a buffer consisting of "nchunks" chunks of "size" bytes,
+//   which are distributed over the threads in the same way
+//   as the loops "#pragma omp parallel for" over the chunks (static schedule),
+//   so that each page is placed on the NUMA node of the thread using it
+void memory_first_touch(
+    void * const ptr,
+    const size_t nchunks,
+    const size_t size
+) {
+  unsigned char * const bytes = ptr;
+#pragma omp parallel for schedule(static)
+  for (size_t n = 0; n < nchunks; n++) {
+    memset(bytes + n * size, 0, size);
+  }
+}
+
+// scratch space of the solvers is reserved per thread rather than per task,
+//   as each thread handles one task at a time:
+//   it is sized for memory_nthreads() threads when a plan is created
+//   and addressed by memory_thread()
+// NOTE: the number of threads is stored in the plan
+//       to limit the teams using the scratch
+size_t memory_nthreads(
+    void
+) {
+#if defined(_OPENMP)
+  return (size_t)omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+size_t memory_thread(
+    void
+) {
+#if defined(_OPENMP)
+  return (size_t)omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+// per-thread scratch would be shared by the threads of different teams
+//   when a solver is called inside a parallel region
+bool memory_in_parallel(
+    void
+) {
+#if defined(_OPENMP)
+  return omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
+// NOTE: memory belonging to an arena is released with the arena
 void memory_free(
     void * const ptr
 ) {
-  free(ptr);
+  if (NULL == ptr) {
+    return;
+  }
+  const header_t * const header = (const header_t *)ptr - 1;
+  if (NULL == header->base) {
+    return;
+  }
+  account(header->tag, header->nbytes, false);
+  free(header->base);
+}
+
+// arena: memory is reserved in large blocks and handed out by bumping an offset,
+//   so that the related arrays are contiguous in memory
+//   and released at once by memory_arena_finalize
+// NOTE: a new block is reserved when the current one is exhausted
+
+// alignment of the blocks, which is the size of huge pages
+//   so that the arrays in an arena may be backed by them
+static const size_t block_alignment = 2 << 20;
+
+typedef struct block_t {
+  struct block_t * next;
+  unsigned char * data;
+  size_t nbytes;
+  size_t offset;
+} block_t;
+
+struct memory_arena_t {
+  memory_tag_t tag;
+  size_t capacity;
+  block_t * blocks;
+};
+
+static block_t * reserve_block(
+    const size_t nbytes,
+    const memory_tag_t tag
+) {
+  block_t * const block = memory_alloc(1, sizeof(block_t), tag);
+  block->next = NULL;
+  block->data = memory_alloc_aligned(nbytes, sizeof(unsigned char), block_alignment, tag);
+  block->nbytes = nbytes;
+  block->offset = 0;
+  return block;
+}
+
+// create an arena whose first block has "capacity" bytes
+memory_arena_t * memory_arena_init(
+    const size_t capacity,
+    const memory_tag_t tag
+) {
+  memory_arena_t * const arena = memory_alloc(1, sizeof(memory_arena_t), tag);
+  arena->tag = tag;
+  arena->capacity = capacity;
+  arena->blocks = reserve_block(capacity, tag);
+  return arena;
+}
+
+// carve out memory from the arena, which is not initialised (see memory_alloc_aligned)
+void * memory_arena_alloc(
+    memory_arena_t * const arena,
+    const size_t nitems,
+    const size_t size,
+    const size_t alignment
+) {
+  const size_t nbytes = find_nbytes(nitems, size);
+  block_t * block = arena->blocks;
+  unsigned char * payload = find_payload(block->data + block->offset, alignment);
+  if (block->data + block->nbytes < payload + nbytes) {
+    const size_t required = nbytes + sizeof(header_t) + alignment;
+    block_t * const new_block = reserve_block(required < arena->capacity ? arena->capacity : required, arena->tag);
+    new_block->next = block;
+    arena->blocks = block = new_block;
+    payload = find_payload(block->data, alignment);
+  }
+  header_t * const header = (header_t *)payload - 1;
+  header->base = NULL;
+  header->nbytes = nbytes;
+  header->tag = arena->tag;
+  block->offset = (size_t)(payload + nbytes - block->data);
+  return payload;
+}
+
+// release all memory in the arena
+void memory_arena_finalize(
+    memory_arena_t ** const arena
+) {
+  block_t * block = (*arena)->blocks;
+  while (NULL != block) {
+    block_t * const next = block->next;
+    memory_free(block->data);
+    memory_free(block);
+    block = next;
+  }
+  memory_free(*arena);
+  *arena = NULL;
+}
+
+// show the current and the peak footprints for each tag
+void memory_report(
+    void
+) {
+  const double mib = 1024. * 1024.;
+  printf("memory footprint (current / peak, MiB)\n");
+  for (size_t n = 0; n < MEMORY_NTAGS; n++) {
+    printf("  %-8s % 10.3f / % 10.3f\n", tag_names[n], current[n] / mib, peak[n] / mib);
+  }
+  printf("  %-8s % 10.3f / % 10.3f\n", "total", current_total / mib, peak_total / mib);
 }
 
@@ -1,30 +1,175 @@
 #include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <errno.h>
 #include <math.h>
 #include "logger.h"
+#include "param.h"
+#include "array.h"
 #include "flow_field.h"
 #include "./monitor.h"
+#include "./telemetry.h"
 
 #define ROOT_DIRECTORY "output/log/"
 
+// number of records kept in memory for each log file,
+//   which are written to the file at once when the buffer is full
+#define BUFFER_SIZE 256
+
+// maximum number of quantities in one record
+#define NITEMS_MAX 16
+
+// store raw records ("*.bin") instead of text ("*.dat"),
+//   each record consists of
+//   step (uint64), time (float64), and nitems quantities (float64)
+#define BINARY_RECORDS false
+
+typedef struct {
+  size_t step;
+  double time;
+  double quantities[NITEMS_MAX];
+} record_t;
+
+// batch of records attached to a log file, written out when the buffer is full,
+//   the file is opened once and kept open until monitor_finalize is called
+typedef struct {
+  const char * const name;
+  const size_t nitems;
+  FILE * fp;
+  size_t count;
+  record_t records[BUFFER_SIZE];
+} log_file_t;
+
+typedef enum {
+  REDUCE_SUM,
+  REDUCE_MAX,
+  REDUCE_MIN,
+} reduction_t;
+
+// quantities evaluated in one sweep over all cells
+enum {
+  DIAG_DIV_MAX = 0,
+  DIAG_DIV_SUM,
+  DIAG_UX_MAX,
+  DIAG_UY_MAX,
+  DIAG_KINETIC_ENERGY,
+  DIAG_ENSTROPHY,
+  DIAG_VORTICITY_MIN,
+  DIAG_VORTICITY_MAX,
+  DIAG_P_MIN,
+  DIAG_P_MAX,
+  DIAG_FORCE_X,
+  DIAG_FORCE_Y,
+  NDIAGS,
+};
+
+// how each quantity is reduced,
+//   sums are multiplied by the cell area when "integral" is true
+static const struct {
+  const char * name;
+  reduction_t reduction;
+  bool integral;
+} diagnostics[NDIAGS] = {
+  [DIAG_DIV_MAX       ] = {.name = "div_max",   .reduction = REDUCE_MAX, .integral = false},
+  [DIAG_DIV_SUM       ] = {.name = "div_sum",   .reduction = REDUCE_SUM, .integral = false},
+  [DIAG_UX_MAX        ] = {.name = "ux_max",    .reduction = REDUCE_MAX, .integral = false},
+  [DIAG_UY_MAX        ] = {.name = "uy_max",    .reduction = REDUCE_MAX, .integral = false},
+  [DIAG_KINETIC_ENERGY] = {.name = "energy",    .reduction = REDUCE_SUM, .integral = true },
+  [DIAG_ENSTROPHY     ] = {.name = "enstrophy", .reduction = REDUCE_SUM, .integral = true },
+  [DIAG_VORTICITY_MIN ] = {.name = "omega_min", .reduction = REDUCE_MIN, .integral = false},
+  [DIAG_VORTICITY_MAX ] = {.name = "omega_max", .reduction = REDUCE_MAX, .integral = false},
+  [DIAG_P_MIN         ] = {.name = "p_min",     .reduction = REDUCE_MIN, .integral = false},
+  [DIAG_P_MAX         ] = {.name = "p_max",     .reduction = REDUCE_MAX, .integral = false},
+  [DIAG_FORCE_X       ] = {.name = "force_x",   .reduction = REDUCE_SUM, .integral = true },
+  [DIAG_FORCE_Y       ] = {.name = "force_y",   .reduction = REDUCE_SUM, .integral = true },
+};
+
+// probe locations, normalised by the domain lengths
+static const double probe_locations[][2] = {
+  {0.50, 0.70},
+  {0.50, 0.60},
+  {0.55, 0.70},
+  {0.50, 0.40},
+};
+
+#define NPROBES (sizeof(probe_locations) / sizeof(probe_locations[0]))
+
+// ux, uy, and p are sampled at each probe
+#define NPROBE_VARS 3
+
+// bilinear interpolation stencil:
+//   value = (1 - wy) * ((1 - wx) * a[j    ][i] + wx * a[j    ][i + 1])
+//         +      wy  * ((1 - wx) * a[j + 1][i] + wx * a[j + 1][i + 1])
+typedef struct {
+  size_t i;
+  size_t j;
+  double wx;
+  double wy;
+} stencil_t;
+
+static stencil_t stencils[NPROBES][NPROBE_VARS] = {0};
+
+enum {
+  LOG_DIAGNOSTICS = 0,
+  LOG_PROBES = 1,
+  NLOGS = 2,
+};
+
+static log_file_t log_files[NLOGS] = {
+  [LOG_DIAGNOSTICS] = {.name = ROOT_DIRECTORY "diagnostics", .nitems = NDIAGS},
+  [LOG_PROBES     ] = {.name = ROOT_DIRECTORY "probes",      .nitems = NPROBES * NPROBE_VARS},
+};
+
+static bool is_initialised = false;
+
+// write all buffered records to the file and empty the buffer
+static int flush(
+    log_file_t * const log_file
+) {
+  FILE * const fp = log_file->fp;
+  const size_t nitems = log_file->nitems;
+  for (size_t n = 0; n < log_file->count; n++) {
+    const record_t * const record = log_file->records + n;
+    if (BINARY_RECORDS) {
+      const uint64_t step = record->step;
+      fwrite(&step, sizeof(uint64_t), 1, fp);
+      fwrite(&record->time, sizeof(double), 1, fp);
+      fwrite(record->quantities, sizeof(double), nitems, fp);
+    } else {
+      fprintf(fp, "%10zu % .15e ", record->step, record->time);
+      for (size_t m = 0; m < nitems; m++) {
+        fprintf(fp, "% .15e%c", record->quantities[m], nitems - 1 == m ? '\n' : ' ');
+      }
+    }
+  }
+  log_file->count = 0;
+  if (0 != fflush(fp)) {
+    perror(log_file->name);
+    return 1;
+  }
+  return 0;
+}
+
 static int output(
     const size_t step,
     const double time,
-    const char file_name[],
-    const size_t nitems,
+    log_file_t * const log_file,
     const double * quantities
 ) {
-  errno = 0;
-  FILE * const fp = fopen(file_name, "a");
-  if (NULL == fp) {
-    perror(file_name);
-    return 1;
+  if (BUFFER_SIZE == log_file->count) {
+    if (0 != flush(log_file)) {
+      return 1;
+    }
+    // messages on the standard output are also flushed in batches
+    fflush(stdout);
   }
-  fprintf(fp, "%10zu % .15e ", step, time);
-  for (size_t n = 0; n < nitems; n++) {
-    fprintf(fp, "% .15e%c", quantities[n], nitems - 1 == n ? '\n' : ' ');
+  record_t * const record = log_file->records + log_file->count;
+  record->step = step;
+  record->time = time;
+  for (size_t n = 0; n < log_file->nitems; n++) {
+    record->quantities[n] = quantities[n];
   }
-  fclose(fp);
+  log_file->count += 1;
   return 0;
 }
 
@@ -42,61 +187,271 @@ static int print(
   return 0;
 }
 
-static int monitor_divergence(
+// evaluate all quantities associated with the cell (j, i):
+//   cell-centered divergence, pressure and body force,
+//   face-centered velocities (ux at i - 1/2, uy at j - 1/2),
+//   and vorticity at the corner (i - 1/2, j - 1/2)
+static inline void evaluate(
+    const domain_t * const domain,
+    const size_t pitch,
+    const real_t * restrict const ux,
+    const real_t * restrict const uy,
+    const real_t * restrict const p,
+    const real_t * restrict const weight,
+    const size_t j,
+    const size_t i,
+    double values[NDIAGS]
+) {
+  const double dx = domain->dx;
+  const double * const dyf = domain->dyf;
+  const double * const dyc = domain->dyc;
+  // velocity gradient tensor at the cell center
+  const double duxdx = (- ux[(j    ) * pitch + (i    )] + ux[(j    ) * pitch + (i + 1)]) / dx;
+  const double duydy = (- uy[(j    ) * pitch + (i    )] + uy[(j + 1) * pitch + (i    )]) / dyf[j];
+  const double duxdy = (
+      - ux[(j - 1) * pitch + (i    )] - ux[(j - 1) * pitch + (i + 1)]
+      + ux[(j + 1) * pitch + (i    )] + ux[(j + 1) * pitch + (i + 1)]
+  ) / (2. * (dyc[j] + dyc[j + 1]));
+  const double duydx = (
+      - uy[(j    ) * pitch + (i - 1)] - uy[(j + 1) * pitch + (i - 1)]
+      + uy[(j    ) * pitch + (i + 1)] + uy[(j + 1) * pitch + (i + 1)]
+  ) / (4. * dx);
+  // velocities on the faces which are updated
+  const double ux_ = ux_imin <= i ? ux[j * pitch + i] : 0.;
+  const double uy_ = uy_jmin <= j ? uy[j * pitch + i] : 0.;
+  const double omega =
+    + (- uy[(j    ) * pitch + (i - 1)] + uy[(j    ) * pitch + (i    )]) / dx
+    - (- ux[(j - 1) * pitch + (i    )] + ux[(j    ) * pitch + (i    )]) / dyc[j];
+  // force exerted on the body, i.e., the surface integral of the stress tensor
+  //   whose normal is given by the gradient of the diffuse indicator
+  const double dwdx = (- weight[(j    ) * pitch + (i - 1)] + weight[(j    ) * pitch + (i + 1)]) / (2. * dx);
+  const double dwdy = (- weight[(j - 1) * pitch + (i    )] + weight[(j + 1) * pitch + (i    )]) / (dyc[j] + dyc[j + 1]);
+  const double sxx = - p[j * pitch + i] + 2. / Re * duxdx;
+  const double syy = - p[j * pitch + i] + 2. / Re * duydy;
+  const double sxy = 1. / Re * (duxdy + duydx);
+  values[DIAG_DIV_MAX       ] = fabs(duxdx + duydy);
+  values[DIAG_DIV_SUM       ] = duxdx + duydy;
+  values[DIAG_UX_MAX        ] = fabs(ux_);
+  values[DIAG_UY_MAX        ] = fabs(uy_);
+  values[DIAG_KINETIC_ENERGY] = 0.5 * (ux_ * ux_ + uy_ * uy_);
+  values[DIAG_ENSTROPHY     ] = 0.5 * omega * omega;
+  values[DIAG_VORTICITY_MIN ] = omega;
+  values[DIAG_VORTICITY_MAX ] = omega;
+  values[DIAG_P_MIN         ] = p[j * pitch + i];
+  values[DIAG_P_MAX         ] = p[j * pitch + i];
+  values[DIAG_FORCE_X       ] = sxx * dwdx + sxy * dwdy;
+  values[DIAG_FORCE_Y       ] = sxy * dwdx + syy * dwdy;
+}
+
+// reduce all registered quantities in a single sweep
+static int monitor_diagnostics(
     const size_t step,
     const double time,
     const domain_t * const domain,
     const flow_field_t * const flow_field
 ) {
-  const char file_name[] = ROOT_DIRECTORY "divergence.dat";
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
   const double dx = domain->dx;
-  const double dy = domain->dy;
-  double ** const ux = flow_field->ux;
-  double ** const uy = flow_field->uy;
-  double div_max = 0.;
-  double div_sum = 0.;
+  const double * const dyf = domain->dyf;
+  // NOTE: all arrays share the same pitch
+  const size_t pitch = array_view(flow_field->ux).pitch;
+  const real_t * restrict const ux = array_view(flow_field->ux).data;
+  const real_t * restrict const uy = array_view(flow_field->uy).data;
+  const real_t * restrict const p = array_view(flow_field->p).data;
+  const real_t * restrict const weight = array_view(flow_field->weight).data;
+  // minima are stored as the maxima of the negated values
+  double sums[NDIAGS] = {0.};
+  double maxs[NDIAGS] = {0.};
+  for (size_t n = 0; n < NDIAGS; n++) {
+    maxs[n] = - INFINITY;
+  }
+#pragma omp parallel for reduction(+: sums[:NDIAGS]) reduction(max: maxs[:NDIAGS])
   for (size_t j = 1; j <= ny; j++) {
     for (size_t i = 1; i <= nx; i++) {
-      const double dux = - ux[j    ][i    ]
-                         + ux[j    ][i + 1];
-      const double duy = - uy[j    ][i    ]
-                         + uy[j + 1][i    ];
-      const double div =
-        + 1. / dx * dux
-        + 1. / dy * duy;
-      div_max = fmax(div_max, fabs(div));
-      div_sum = div_sum + div;
+      double values[NDIAGS] = {0.};
+      evaluate(domain, pitch, ux, uy, p, weight, j, i, values);
+      for (size_t n = 0; n < NDIAGS; n++) {
+        switch (diagnostics[n].reduction) {
+          case REDUCE_SUM:
+            // integrals are weighted by the cell heights
+            sums[n] += diagnostics[n].integral ? values[n] * dyf[j] : values[n];
+            break;
+          case REDUCE_MAX:
+            maxs[n] = fmax(maxs[n], values[n]);
+            break;
+          case REDUCE_MIN:
+            maxs[n] = fmax(maxs[n], - values[n]);
+            break;
+        }
+      }
+    }
+  }
+  double quantities[NDIAGS] = {0.};
+  for (size_t n = 0; n < NDIAGS; n++) {
+    switch (diagnostics[n].reduction) {
+      case REDUCE_SUM:
+        quantities[n] = diagnostics[n].integral ? sums[n] * dx : sums[n];
+        break;
+      case REDUCE_MAX:
+        quantities[n] = maxs[n];
+        break;
+      case REDUCE_MIN:
+        quantities[n] = - maxs[n];
+        break;
     }
   }
-  return output(step, time, file_name, 2, (double []){div_max, div_sum});
+  const char * names[NDIAGS] = {NULL};
+  for (size_t n = 0; n < NDIAGS; n++) {
+    names[n] = diagnostics[n].name;
+  }
+  telemetry_publish_diagnostics(NDIAGS, names, quantities);
+  return output(step, time, log_files + LOG_DIAGNOSTICS, quantities);
 }
 
-static int monitor_max_velocity(
-    const size_t step,
-    const double time,
+// find the lower-left neighbour and the weights of a location,
+//   where the index i is located at (i - xoffset) * dx
+//   and the index j is located at ys[j]
+static stencil_t find_stencil(
     const domain_t * const domain,
-    const flow_field_t * const flow_field
+    const double xoffset,
+    const double * const ys,
+    const double location[2]
 ) {
-  const char file_name[] = ROOT_DIRECTORY "max_velocity.dat";
   const size_t nx = domain->nx;
   const size_t ny = domain->ny;
-  double ** const ux = flow_field->ux;
-  double ** const uy = flow_field->uy;
-  double ux_max = 0.;
-  double uy_max = 0.;
-  for (size_t j = 1; j <= ny; j++) {
-    for (size_t i = ux_imin; i <= nx; i++) {
-      ux_max = fmax(ux_max, fabs(ux[j    ][i    ]));
+  const double dx = domain->dx;
+  // keep the stencil inside the array including halo cells
+  const double k = location[0] / dx + xoffset;
+  const double k0 = fmin(fmax(floor(k), 0.), 1. * nx);
+  const double y = location[1];
+  size_t j = 0;
+  while (j < ny && ys[j + 1] <= y) {
+    j += 1;
+  }
+  return (stencil_t){
+    .i = (size_t)k0,
+    .j = j,
+    .wx = fmin(fmax(k - k0, 0.), 1.),
+    .wy = fmin(fmax((y - ys[j]) / (ys[j + 1] - ys[j]), 0.), 1.),
+  };
+}
+
+static int init_probes(
+    const domain_t * const domain
+) {
+  const double lx = domain->lx;
+  const double ly = domain->ly;
+  // staggered positions: ux (i - 1, yc), uy (i - 1/2, yf), p (i - 1/2, yc)
+  const double xoffsets[NPROBE_VARS] = {1.0, 0.5, 0.5};
+  const double * const ys[NPROBE_VARS] = {domain->yc, domain->yf, domain->yc};
+  for (size_t n = 0; n < NPROBES; n++) {
+    const double location[2] = {
+      lx * probe_locations[n][0],
+      ly * probe_locations[n][1],
+    };
+    for (size_t m = 0; m < NPROBE_VARS; m++) {
+      stencils[n][m] = find_stencil(domain, xoffsets[m], ys[m], location);
     }
   }
-  for (size_t j = uy_jmin; j <= ny; j++) {
-    for (size_t i = 1; i <= nx; i++) {
-      uy_max = fmax(uy_max, fabs(uy[j    ][i    ]));
+  // header lines describing the probes, only for a new text file
+  if (!BINARY_RECORDS) {
+    FILE * const fp = log_files[LOG_PROBES].fp;
+    if (0 == fseek(fp, 0, SEEK_END) && 0 == ftell(fp)) {
+      for (size_t n = 0; n < NPROBES; n++) {
+        fprintf(fp, "# probe %zu: x % .15e y % .15e\n", n, lx * probe_locations[n][0], ly * probe_locations[n][1]);
+      }
+      fprintf(fp, "# step time");
+      for (size_t n = 0; n < NPROBES; n++) {
+        fprintf(fp, " ux%zu uy%zu p%zu", n, n, n);
+      }
+      fprintf(fp, "\n");
+    }
+  }
+  return 0;
+}
+
+static double interpolate(
+    real_t * const * const array,
+    const stencil_t * const stencil
+) {
+  const size_t i = stencil->i;
+  const size_t j = stencil->j;
+  const double wx = stencil->wx;
+  const double wy = stencil->wy;
+  return
+    + (1. - wy) * ((1. - wx) * array[j    ][i    ] + wx * array[j    ][i + 1])
+    + (     wy) * ((1. - wx) * array[j + 1][i    ] + wx * array[j + 1][i + 1]);
+}
+
+// sample flow fields at all probes using the precomputed stencils
+int monitor_probes(
+    const size_t step,
+    const double time,
+    const flow_field_t * const flow_field
+) {
+  real_t * const * const arrays[NPROBE_VARS] = {
+    flow_field->ux,
+    flow_field->uy,
+    flow_field->p,
+  };
+  double quantities[NPROBES * NPROBE_VARS] = {0.};
+  for (size_t n = 0; n < NPROBES; n++) {
+    for (size_t m = 0; m < NPROBE_VARS; m++) {
+      quantities[n * NPROBE_VARS + m] = interpolate(arrays[m], &stencils[n][m]);
     }
   }
-  return output(step, time, file_name, 2, (double []){ux_max, uy_max});
+  if (0 != output(step, time, log_files + LOG_PROBES, quantities)) {
+    LOGGER_FAILURE("failed to output probes");
+    return 1;
+  }
+  return 0;
+}
+
+// open log files (appending to the existing ones to support restart),
+//   prepare probes, and make the standard output fully buffered
+int monitor_init(
+    const domain_t * const domain
+) {
+  const char * const suffix = BINARY_RECORDS ? ".bin" : ".dat";
+  const char * const mode = BINARY_RECORDS ? "ab" : "a";
+  for (size_t n = 0; n < NLOGS; n++) {
+    log_file_t * const log_file = log_files + n;
+    if (NITEMS_MAX < log_file->nitems) {
+      LOGGER_FAILURE("too many quantities in one record, increase NITEMS_MAX");
+      goto abort;
+    }
+    char file_name[256] = {'\0'};
+    snprintf(file_name, sizeof(file_name), "%s%s", log_file->name, suffix);
+    errno = 0;
+    log_file->fp = fopen(file_name, mode);
+    if (NULL == log_file->fp) {
+      perror(file_name);
+      LOGGER_FAILURE("failed to open log file");
+      goto abort;
+    }
+    log_file->count = 0;
+  }
+  // header line describing the columns, only for a new text file
+  if (!BINARY_RECORDS) {
+    FILE * const fp = log_files[LOG_DIAGNOSTICS].fp;
+    if (0 == fseek(fp, 0, SEEK_END) && 0 == ftell(fp)) {
+      fprintf(fp, "# step time");
+      for (size_t n = 0; n < NDIAGS; n++) {
+        fprintf(fp, " %s", diagnostics[n].name);
+      }
+      fprintf(fp, "\n");
+    }
+  }
+  if (0 != init_probes(domain)) {
+    LOGGER_FAILURE("failed to initialise probes");
+    goto abort;
+  }
+  is_initialised = true;
+  return 0;
+abort:
+  monitor_finalize();
+  return 1;
 }
 
 int monitor(
@@ -106,16 +461,16 @@ int monitor(
     const domain_t * const domain,
     const flow_field_t * const flow_field
 ) {
-  if (0 != print(step, time, dt)) {
-    LOGGER_FAILURE("failed to output metrics");
+  if (!is_initialised) {
+    LOGGER_FAILURE("monitor_init should be called in advance");
     goto abort;
   }
-  if (0 != monitor_divergence(step, time, domain, flow_field)) {
-    LOGGER_FAILURE("failed to check / output divergence");
+  if (0 != print(step, time, dt)) {
+    LOGGER_FAILURE("failed to output metrics");
     goto abort;
   }
-  if (0 != monitor_max_velocity(step, time, domain, flow_field)) {
-    LOGGER_FAILURE("failed to check / output maximum velocity");
+  if (0 != monitor_diagnostics(step, time, domain, flow_field)) {
+    LOGGER_FAILURE("failed to evaluate / output diagnostics");
     goto abort;
   }
   return 0;
@@ -124,3 +479,34 @@ abort:
   return 1;
 }
 
+// write the buffered records to the files, e.g., before checkpointing
+int monitor_flush(
+    void
+) {
+  int error_code = 0;
+  for (size_t n = 0; n < NLOGS; n++) {
+    log_file_t * const log_file = log_files + n;
+    if (NULL != log_file->fp) {
+      error_code += flush(log_file);
+    }
+  }
+  fflush(stdout);
+  return error_code;
+}
+
+// flush the remaining records and close log files
+int monitor_finalize(
+    void
+) {
+  const int error_code = monitor_flush();
+  for (size_t n = 0; n < NLOGS; n++) {
+    log_file_t * const log_file = log_files + n;
+    if (NULL != log_file->fp) {
+      fclose(log_file->fp);
+      log_file->fp = NULL;
+    }
+  }
+  is_initialised = false;
+  return error_code;
+}
+
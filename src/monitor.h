@@ -5,6 +5,10 @@
 #include "domain.h" // domain_t
 #include "flow_field.h" // flow_field_t
 
+extern int monitor_init(
+    const domain_t * const domain
+);
+
 extern int monitor(
     const size_t step,
     const double time,
@@ -13,4 +17,18 @@ extern int monitor(
     const flow_field_t * const flow_field
 );
 
+extern int monitor_probes(
+    const size_t step,
+    const double time,
+    const flow_field_t * const flow_field
+);
+
+extern int monitor_flush(
+    void
+);
+
+extern int monitor_finalize(
+    void
+);
+
 #endif // MONITOR_H
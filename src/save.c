@@ -1,27 +1,45 @@
-#include <stdio.h> // snprintf
-#include <stdbool.h> // false
-#include <string.h> // strlen
+// opendir, readdir, closedir, unlink, rmdir, fileno, ftruncate, fsync
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // snprintf, fileno
+#include <stdbool.h> // bool, true, false
+#include <string.h> // strlen, strcmp, strncmp, memchr, memcpy
 #include <errno.h> // errno, EEXIST
+#include <dirent.h> // DIR, opendir, readdir, closedir
+#include <fcntl.h> // open, O_RDONLY
+#include <unistd.h> // unlink, rmdir, ftruncate, fsync, close
+#include <sys/mman.h> // mmap, msync, munmap
 #include <sys/stat.h> // mode_t, S_IRWXU, S_IRWXG, S_IRWXO
 #include "memory.h"
 #include "logger.h"
 #include "domain.h"
 #include "flow_field.h"
+#include "statistics.h"
 #include "./save.h"
 #include "./save/snpyio.h"
+#include "./save/compress.h"
 
 #define ROOT_DIRECTORY "output/save/"
+#define CHECKPOINT_DIRECTORY "output/checkpoint/"
+#define STATISTICS_DIRECTORY "output/statistics/"
 
 #define NDIMS 2
 
+// store flow fields as compressed streams (*.nsz) instead of NPY files
+#define COMPRESS_FIELDS false
+
+// write NPY files through memory mapping, so that flow fields are packed
+//   directly into the files by all threads (ignored when COMPRESS_FIELDS is enabled)
+#define MAP_FIELDS false
+
 static int concat_dir_name(
+    const char prefix[],
     const size_t id,
     char ** const dir_name
 ){
-  const char prefix[] = ROOT_DIRECTORY;
   const int ndigits = 10;
   const int nchars = strlen(prefix) + ndigits + 1;
-  *dir_name = memory_alloc(nchars, sizeof(char));
+  *dir_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
   (*dir_name)[nchars - 1] = '\0';
   if (nchars - 1 != snprintf(*dir_name, nchars, "%s%0*zu", prefix, ndigits, id)) {
     LOGGER_FAILURE("snprintf returns unexpected result");
@@ -37,9 +55,11 @@ static int create_directory(
 ){
   errno = 0;
   if (0 != mkdir(dir_name, S_IRWXU | S_IRWXG | S_IRWXO)) {
+    // NOTE: perror may overwrite errno
+    const int mkdir_errno = errno;
     perror(dir_name);
     // treat EEXIST as expected to override present files
-    if (EEXIST != errno) {
+    if (EEXIST != mkdir_errno) {
       LOGGER_FAILURE("failed to create a directory (other than 'already exist' error)");
       goto abort;
     }
@@ -49,6 +69,111 @@ abort:
   return 1;
 }
 
+// remove a directory together with the files inside
+static int remove_directory(
+    const char dir_name[]
+){
+  errno = 0;
+  DIR * const dir = opendir(dir_name);
+  if (NULL == dir) {
+    perror(dir_name);
+    goto abort;
+  }
+  for (struct dirent * entry = NULL; NULL != (entry = readdir(dir)); ) {
+    if (0 == strcmp(entry->d_name, ".") || 0 == strcmp(entry->d_name, "..")) {
+      continue;
+    }
+    const int nchars = strlen(dir_name) + strlen(entry->d_name) + 2;
+    char * const file_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
+    snprintf(file_name, nchars, "%s/%s", dir_name, entry->d_name);
+    if (0 != unlink(file_name)) {
+      perror(file_name);
+    }
+    memory_free(file_name);
+  }
+  closedir(dir);
+  if (0 != rmdir(dir_name)) {
+    perror(dir_name);
+    goto abort;
+  }
+  return 0;
+abort:
+  return 1;
+}
+
+// flush a file or a directory to the storage device
+static int sync_path(
+    const char path[]
+){
+  errno = 0;
+  const int fd = open(path, O_RDONLY);
+  if (-1 == fd) {
+    perror(path);
+    return 1;
+  }
+  const int error_code = 0 == fsync(fd) ? 0 : 1;
+  if (0 != error_code) {
+    perror(path);
+  }
+  close(fd);
+  return error_code;
+}
+
+// flush the files inside a directory, the directory itself, and its parent,
+//   so that the directory survives a system crash
+// NOTE: this covers the memory-mapped files as well,
+//       whose dirty pages remain in the page cache after munmap
+static int sync_directory(
+    const char parent_name[],
+    const char dir_name[]
+){
+  int error_code = 0;
+  errno = 0;
+  DIR * const dir = opendir(dir_name);
+  if (NULL == dir) {
+    perror(dir_name);
+    return 1;
+  }
+  for (struct dirent * entry = NULL; NULL != (entry = readdir(dir)); ) {
+    if (0 == strcmp(entry->d_name, ".") || 0 == strcmp(entry->d_name, "..")) {
+      continue;
+    }
+    const int nchars = strlen(dir_name) + strlen(entry->d_name) + 2;
+    char * const file_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
+    snprintf(file_name, nchars, "%s/%s", dir_name, entry->d_name);
+    error_code += sync_path(file_name);
+    memory_free(file_name);
+  }
+  closedir(dir);
+  error_code += sync_path(dir_name);
+  error_code += sync_path(parent_name);
+  return error_code;
+}
+
+static int concat_file_name(
+    const char dir_name[],
+    const char dset_name[],
+    const char suffix[],
+    char ** const file_name
+){
+  const char slash[] = {"/"};
+  const int nchars =
+    + strlen( dir_name)
+    + strlen(    slash)
+    + strlen(dset_name)
+    + strlen(   suffix)
+    + 1;
+  *file_name = memory_alloc(nchars, sizeof(char), MEMORY_TAG_IO);
+  (*file_name)[nchars - 1] = '\0';
+  if (nchars - 1 != snprintf(*file_name, nchars, "%s%s%s%s", dir_name, slash, dset_name, suffix)) {
+    LOGGER_FAILURE("snprintf returns unexpected result");
+    goto abort;
+  }
+  return 0;
+abort:
+  return 1;
+}
+
 static int write_npy_file(
     const char dir_name[],
     const char dset_name[],
@@ -63,22 +188,9 @@ static int write_npy_file(
   FILE * fp = NULL;
   size_t header_size = 0;
   // assign file_name
-  {
-    const char slash[] = {"/"};
-    const char suffix[] = {".npy"};
-    const int nchars =
-      + strlen( dir_name)
-      + strlen(    slash)
-      + strlen(dset_name)
-      + strlen(   suffix)
-      + 1;
-    file_name = memory_alloc(nchars, sizeof(char));
-    file_name[nchars - 1] = '\0';
-    if (nchars - 1 != snprintf(file_name, nchars, "%s%s%s%s", dir_name, slash, dset_name, suffix)) {
-      error_code = 1;
-      LOGGER_FAILURE("snprintf returns unexpected result");
-      goto abort;
-    }
+  if (0 != concat_file_name(dir_name, dset_name, ".npy", &file_name)) {
+    error_code = 1;
+    goto abort;
   }
   // write npy header
   {
@@ -131,6 +243,204 @@ abort:
   return error_code;
 }
 
+// compress a two-dimensional data set and write it to "dset_name.nsz"
+//   see save/compress/README.md for the format
+static int write_compressed_file(
+    const char dir_name[],
+    const char dset_name[],
+    const size_t * shape,
+    const size_t size,
+    const void * data,
+    const double error_bound
+){
+  int error_code = 0;
+  char * file_name = NULL;
+  FILE * fp = NULL;
+  size_t nbytes = 0;
+  unsigned char * bytes = NULL;
+  if (0 != concat_file_name(dir_name, dset_name, ".nsz", &file_name)) {
+    error_code = 1;
+    goto abort;
+  }
+  if (0 != compress(shape[0], shape[1], size, data, error_bound, &nbytes, &bytes)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to compress data");
+    goto abort;
+  }
+  errno = 0;
+  fp = fopen(file_name, "w");
+  if (NULL == fp) {
+    perror(file_name);
+    error_code = 1;
+    LOGGER_FAILURE("failed to open file (attempted to write compressed data)");
+    goto abort;
+  }
+  if (nbytes != fwrite(bytes, sizeof(unsigned char), nbytes, fp)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to write compressed data");
+    goto abort;
+  }
+abort:
+  memory_free(file_name);
+  memory_free(bytes);
+  if (NULL != fp) {
+    fclose(fp);
+  }
+  return error_code;
+}
+
+// number of stored points in each direction,
+//   taking every "stride"-th point in [0 : n + 1] (halo) or [1 : n] (interior)
+static int get_packed_shape(
+    const size_t nx,
+    const size_t ny,
+    const bool halo,
+    const size_t stride,
+    size_t shape[NDIMS]
+){
+  const size_t nitems[NDIMS] = {
+    halo ? ny + 2 : ny,
+    halo ? nx + 2 : nx,
+  };
+  for (size_t dim = 0; dim < NDIMS; dim++) {
+    shape[dim] = (nitems[dim] - 1) / stride + 1;
+  }
+  return 0;
+}
+
+// gather (sub-sampled, type-converted) values into a contiguous buffer
+static int pack(
+    real_t * const * const array,
+    const bool halo,
+    const size_t stride,
+    const size_t shape[NDIMS],
+    const size_t size,
+    void * const buf
+){
+  const size_t offset = halo ? 0 : 1;
+#pragma omp parallel for
+  for (size_t j = 0; j < shape[0]; j++) {
+    const real_t * const row = array[offset + j * stride] + offset;
+    if (sizeof(double) == size) {
+      double * const dest = (double *)buf + j * shape[1];
+      for (size_t i = 0; i < shape[1]; i++) {
+        dest[i] = row[i * stride];
+      }
+    } else {
+      float * const dest = (float *)buf + j * shape[1];
+      for (size_t i = 0; i < shape[1]; i++) {
+        dest[i] = (float)row[i * stride];
+      }
+    }
+  }
+  return 0;
+}
+
+// write NPY header, extend the file to the final size,
+//   and pack the array directly into the memory-mapped payload
+static int write_mapped_npy_file(
+    const char dir_name[],
+    const char dset_name[],
+    real_t * const * const array,
+    const bool halo,
+    const size_t stride,
+    const size_t shape[NDIMS],
+    const char dtype[],
+    const size_t size
+){
+  int error_code = 0;
+  char * file_name = NULL;
+  FILE * fp = NULL;
+  void * addr = MAP_FAILED;
+  size_t length = 0;
+  if (0 != concat_file_name(dir_name, dset_name, ".npy", &file_name)) {
+    error_code = 1;
+    goto abort;
+  }
+  errno = 0;
+  fp = fopen(file_name, "w+");
+  if (NULL == fp) {
+    perror(file_name);
+    error_code = 1;
+    LOGGER_FAILURE("failed to open file (attempted to write NPY header)");
+    goto abort;
+  }
+  size_t header_size = 0;
+  if (0 != snpyio_w_header(NDIMS, shape, dtype, false, fp, &header_size)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to write NPY header");
+    goto abort;
+  }
+  if (0 != fflush(fp)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to flush NPY header");
+    goto abort;
+  }
+  length = header_size + shape[0] * shape[1] * size;
+  const int fd = fileno(fp);
+  errno = 0;
+  if (0 != ftruncate(fd, (off_t)length)) {
+    perror(file_name);
+    error_code = 1;
+    LOGGER_FAILURE("failed to extend file");
+    goto abort;
+  }
+  errno = 0;
+  addr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (MAP_FAILED == addr) {
+    perror(file_name);
+    error_code = 1;
+    LOGGER_FAILURE("failed to map file");
+    goto abort;
+  }
+  pack(array, halo, stride, shape, size, (char *)addr + header_size);
+  // initiate write-back without waiting for it
+  if (0 != msync(addr, length, MS_ASYNC)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to schedule write-back");
+    goto abort;
+  }
+abort:
+  if (MAP_FAILED != addr) {
+    munmap(addr, length);
+  }
+  memory_free(file_name);
+  if (NULL != fp) {
+    fclose(fp);
+  }
+  return error_code;
+}
+
+// store a flow field following the given output setting
+static int write_field(
+    const char dir_name[],
+    const char dset_name[],
+    const size_t nx,
+    const size_t ny,
+    real_t * const * const array,
+    const size_t size,
+    const bool halo,
+    const size_t stride,
+    const double error_bound
+){
+  int error_code = 0;
+  size_t shape[NDIMS] = {0};
+  get_packed_shape(nx, ny, halo, stride, shape);
+  const char * const dtype = sizeof(double) == size ? "'<f8'" : "'<f4'";
+  if (!COMPRESS_FIELDS && MAP_FIELDS) {
+    return write_mapped_npy_file(dir_name, dset_name, array, halo, stride, shape, dtype, size);
+  }
+  void * const buf = memory_alloc(shape[0] * shape[1], size, MEMORY_TAG_IO);
+  pack(array, halo, stride, shape, size, buf);
+  if (COMPRESS_FIELDS) {
+    error_code = write_compressed_file(dir_name, dset_name, shape, size, buf, error_bound);
+  } else {
+    error_code = write_npy_file(dir_name, dset_name, NDIMS, shape, dtype, size, buf);
+  }
+  memory_free(buf);
+  return error_code;
+}
+
 int save(
     const size_t id,
     const size_t step,
@@ -140,7 +450,7 @@ int save(
 ) {
   int error_code = 0;
   char * dir_name = NULL;
-  if (0 != concat_dir_name(id, &dir_name)) {
+  if (0 != concat_dir_name(ROOT_DIRECTORY, id, &dir_name)) {
     error_code = 1;
     LOGGER_FAILURE("failed to concatenate directory name");
     goto abort;
@@ -154,11 +464,228 @@ int save(
   const size_t ny = domain->ny;
   write_npy_file(dir_name, "step", 0, NULL, "'<u8'", sizeof(size_t), &step);
   write_npy_file(dir_name, "time", 0, NULL, "'<f8'", sizeof(double), &time);
-  write_npy_file(dir_name, "ux", NDIMS, (size_t [NDIMS]){ny + 2, nx + 2}, "'<f8'", sizeof(double), &flow_field->ux[0][0]);
-  write_npy_file(dir_name, "uy", NDIMS, (size_t [NDIMS]){ny + 2, nx + 2}, "'<f8'", sizeof(double), &flow_field->uy[0][0]);
-  write_npy_file(dir_name,  "p", NDIMS, (size_t [NDIMS]){ny + 2, nx + 2}, "'<f8'", sizeof(double), &flow_field-> p[0][0]);
+  // positions in y including halo cells, which can be non-uniform
+  {
+    const size_t shape[1] = {ny + 2};
+    write_npy_file(dir_name, "yf", 1, shape, "'<f8'", sizeof(double), domain->yf);
+    write_npy_file(dir_name, "yc", 1, shape, "'<f8'", sizeof(double), domain->yc);
+  }
+  // output settings of each field
+  //   size        : sizeof(double) (float64) or sizeof(float) (float32),
+  //                 sizeof(real_t) keeps the precision of the simulation
+  //   halo        : store halo cells (which hold boundary conditions) or interior only
+  //   stride      : store every "stride"-th point in each direction (sub-sampling)
+  //   error_bound : absolute error bound used when COMPRESS_FIELDS is enabled (0 for lossless)
+  const struct {
+    const char * name;
+    real_t ** array;
+    size_t size;
+    bool halo;
+    size_t stride;
+    double error_bound;
+  } fields[] = {
+    {.name = "ux", .array = flow_field->ux, .size = sizeof(real_t), .halo = true, .stride = 1, .error_bound = 0.},
+    {.name = "uy", .array = flow_field->uy, .size = sizeof(real_t), .halo = true, .stride = 1, .error_bound = 0.},
+    {.name =  "p", .array = flow_field-> p, .size = sizeof(real_t), .halo = true, .stride = 1, .error_bound = 0.},
+  };
+  for (size_t n = 0; n < sizeof(fields) / sizeof(fields[0]); n++) {
+    const size_t size = fields[n].size;
+    const bool halo = fields[n].halo;
+    const size_t stride = fields[n].stride;
+    if ((sizeof(double) != size && sizeof(float) != size) || 0 == stride) {
+      error_code = 1;
+      LOGGER_FAILURE("invalid output setting");
+      goto abort;
+    }
+    write_field(dir_name, fields[n].name, nx, ny, fields[n].array, size, halo, stride, fields[n].error_bound);
+  }
+abort:
+  memory_free(dir_name);
+  return error_code;
+}
+
+// store a whole array (including halo cells) in double precision
+static int write_full_field(
+    const char dir_name[],
+    const char dset_name[],
+    const size_t nx,
+    const size_t ny,
+    real_t * const * const array
+){
+  int error_code = 0;
+  size_t shape[NDIMS] = {0};
+  get_packed_shape(nx, ny, true, 1, shape);
+  if (MAP_FIELDS) {
+    return write_mapped_npy_file(dir_name, dset_name, array, true, 1, shape, "'<f8'", sizeof(double));
+  }
+  double * const buf = memory_alloc(shape[0] * shape[1], sizeof(double), MEMORY_TAG_IO);
+  pack(array, true, 1, shape, sizeof(double), buf);
+  error_code = write_npy_file(dir_name, dset_name, NDIMS, shape, "'<f8'", sizeof(double), buf);
+  memory_free(buf);
+  return error_code;
+}
+
+static int write_statistics(
+    const char dir_name[],
+    const domain_t * const domain,
+    const statistics_t * const statistics
+){
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  int error_code = 0;
+  error_code += write_npy_file(dir_name, "stat_nsamples", 0, NULL, "'<u8'", sizeof(size_t), &statistics->nsamples);
+  const struct {
+    const char * name;
+    real_t ** array;
+  } fields[] = {
+    {.name = "stat_ux_mean",  .array = statistics->ux_mean },
+    {.name = "stat_ux_m2",    .array = statistics->ux_m2   },
+    {.name = "stat_uy_mean",  .array = statistics->uy_mean },
+    {.name = "stat_uy_m2",    .array = statistics->uy_m2   },
+    {.name = "stat_p_mean",   .array = statistics-> p_mean },
+    {.name = "stat_p_m2",     .array = statistics-> p_m2   },
+    {.name = "stat_uxc_mean", .array = statistics->uxc_mean},
+    {.name = "stat_uyc_mean", .array = statistics->uyc_mean},
+    {.name = "stat_uxuy_m2",  .array = statistics->uxuy_m2 },
+  };
+  for (size_t n = 0; n < sizeof(fields) / sizeof(fields[0]); n++) {
+    error_code += write_full_field(dir_name, fields[n].name, nx, ny, fields[n].array);
+  }
+  return error_code;
+}
+
+// write accumulated statistics to "STATISTICS_DIRECTORY/<step>"
+int save_statistics(
+    const size_t step,
+    const double time,
+    const domain_t * const domain,
+    const statistics_t * const statistics
+) {
+  int error_code = 0;
+  char * dir_name = NULL;
+  if (0 != concat_dir_name(STATISTICS_DIRECTORY, step, &dir_name)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to concatenate directory name");
+    goto abort;
+  }
+  if (0 != create_directory(dir_name)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to create a directory");
+    goto abort;
+  }
+  error_code += write_npy_file(dir_name, "step", 0, NULL, "'<u8'", sizeof(size_t), &step);
+  error_code += write_npy_file(dir_name, "time", 0, NULL, "'<f8'", sizeof(double), &time);
+  error_code += write_statistics(dir_name, domain, statistics);
+  if (0 != error_code) {
+    LOGGER_FAILURE("failed to write statistics");
+  }
 abort:
   memory_free(dir_name);
   return error_code;
 }
 
+// latest checkpoint, which is removed when the next one is written
+static char * previous_dir_name = NULL;
+
+// take over the checkpoint from which the simulation is restarted,
+//   so that it is rotated away as well when the next one is written
+// NOTE: only directories given as "CHECKPOINT_DIRECTORY<step>" are taken over,
+//       while others (e.g. snapshots or copies elsewhere) are kept
+int checkpoint_init(
+    const char restart_dir_name[]
+) {
+  const size_t nchars_prefix = strlen(CHECKPOINT_DIRECTORY);
+  if (NULL == restart_dir_name || 0 != strncmp(restart_dir_name, CHECKPOINT_DIRECTORY, nchars_prefix)) {
+    return 0;
+  }
+  // ignore trailing slashes
+  size_t nchars = strlen(restart_dir_name);
+  while (nchars_prefix < nchars && '/' == restart_dir_name[nchars - 1]) {
+    nchars -= 1;
+  }
+  if (nchars_prefix == nchars || NULL != memchr(restart_dir_name + nchars_prefix, '/', nchars - nchars_prefix)) {
+    return 0;
+  }
+  previous_dir_name = memory_alloc(nchars + 1, sizeof(char), MEMORY_TAG_IO);
+  memcpy(previous_dir_name, restart_dir_name, nchars);
+  previous_dir_name[nchars] = '\0';
+  return 0;
+}
+
+// write full-precision flow fields (independent of the output settings of save)
+//   and statistics to "CHECKPOINT_DIRECTORY/<step>",
+//   from which the simulation can be restarted
+// NOTE: the previous checkpoint is removed only after the new one
+//       is written and flushed to the storage device,
+//       while an incomplete one is removed so that it is not mistaken for the latest
+int checkpoint(
+    const size_t step,
+    const double time,
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const statistics_t * const statistics
+) {
+  int error_code = 0;
+  bool is_created = false;
+  char * dir_name = NULL;
+  if (0 != concat_dir_name(CHECKPOINT_DIRECTORY, step, &dir_name)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to concatenate directory name");
+    goto abort;
+  }
+  // the state at this step is already kept,
+  //   which should not be overwritten
+  if (NULL != previous_dir_name && 0 == strcmp(previous_dir_name, dir_name)) {
+    memory_free(dir_name);
+    return 0;
+  }
+  if (0 != create_directory(dir_name)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to create a directory");
+    goto abort;
+  }
+  is_created = true;
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  error_code += write_npy_file(dir_name, "step", 0, NULL, "'<u8'", sizeof(size_t), &step);
+  error_code += write_npy_file(dir_name, "time", 0, NULL, "'<f8'", sizeof(double), &time);
+  error_code += write_full_field(dir_name, "ux", nx, ny, flow_field->ux);
+  error_code += write_full_field(dir_name, "uy", nx, ny, flow_field->uy);
+  error_code += write_full_field(dir_name,  "p", nx, ny, flow_field-> p);
+  {
+    const size_t shape[1] = {2};
+    error_code += write_npy_file(dir_name, "body_center",   1, shape, "'<f8'", sizeof(double), flow_field->body.center);
+    error_code += write_npy_file(dir_name, "body_velocity", 1, shape, "'<f8'", sizeof(double), flow_field->body.velocity);
+  }
+  error_code += write_statistics(dir_name, domain, statistics);
+  if (0 != error_code) {
+    LOGGER_FAILURE("failed to write checkpoint, keep the previous one");
+    goto abort;
+  }
+  if (0 != sync_directory(CHECKPOINT_DIRECTORY, dir_name)) {
+    error_code = 1;
+    LOGGER_FAILURE("failed to flush checkpoint, keep the previous one");
+    goto abort;
+  }
+  if (NULL != previous_dir_name) {
+    remove_directory(previous_dir_name);
+    memory_free(previous_dir_name);
+  }
+  previous_dir_name = dir_name;
+  return 0;
+abort:
+  if (is_created) {
+    remove_directory(dir_name);
+  }
+  memory_free(dir_name);
+  return error_code;
+}
+
+// release the name of the latest checkpoint, which is kept
+int checkpoint_finalize(
+    void
+) {
+  memory_free(previous_dir_name);
+  previous_dir_name = NULL;
+  return 0;
+}
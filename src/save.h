@@ -4,6 +4,7 @@
 #include <stddef.h> // size_t
 #include "domain.h" // domain_t
 #include "flow_field.h" // flow_field_t
+#include "statistics.h" // statistics_t
 
 extern int save(
     const size_t id,
@@ -13,4 +14,27 @@ extern int save(
     const flow_field_t * const flow_field
 );
 
+extern int save_statistics(
+    const size_t step,
+    const double time,
+    const domain_t * const domain,
+    const statistics_t * const statistics
+);
+
+extern int checkpoint_init(
+    const char restart_dir_name[]
+);
+
+extern int checkpoint(
+    const size_t step,
+    const double time,
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    const statistics_t * const statistics
+);
+
+extern int checkpoint_finalize(
+    void
+);
+
 #endif // SAVE_H
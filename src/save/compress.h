@@ -0,0 +1,30 @@
+#if !defined(COMPRESS_H)
+#define COMPRESS_H
+
+#include <stddef.h> // size_t
+
+// compress a row-major two-dimensional array of "size"-byte (4 or 8) floating-point numbers
+// NOTE: error_bound = 0 gives a lossless stream,
+//       while positive error_bound quantises each value with the given absolute tolerance
+// NOTE: the resulting stream (allocated here) is self-contained
+extern int compress(
+    const size_t nrows,
+    const size_t ncols,
+    const size_t size,
+    const void * const data,
+    const double error_bound,
+    size_t * const nbytes,
+    unsigned char ** const bytes
+);
+
+// recover the array (allocated here) from a stream created by compress
+extern int decompress(
+    const size_t nbytes,
+    const unsigned char * const bytes,
+    size_t * const nrows,
+    size_t * const ncols,
+    size_t * const size,
+    void ** const data
+);
+
+#endif // COMPRESS_H
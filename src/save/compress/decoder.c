@@ -0,0 +1,104 @@
+#if defined(COMPRESS_DECODER)
+
+// convert compressed streams (*.nsz) back to NPY files (*.npy)
+//   usage: ./decoder.out output/save/0000000000/ux.nsz [...]
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include "memory.h"
+#include "../snpyio.h"
+#include "../compress.h"
+
+static int load(
+    const char file_name[],
+    size_t * const nbytes,
+    unsigned char ** const bytes
+) {
+  errno = 0;
+  FILE * const fp = fopen(file_name, "r");
+  if (NULL == fp) {
+    perror(file_name);
+    return 1;
+  }
+  fseek(fp, 0, SEEK_END);
+  const long nbytes_ = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if (nbytes_ <= 0) {
+    fclose(fp);
+    return 1;
+  }
+  *nbytes = (size_t)nbytes_;
+  *bytes = memory_alloc(*nbytes, sizeof(unsigned char), MEMORY_TAG_IO);
+  const size_t nread = fread(*bytes, sizeof(unsigned char), *nbytes, fp);
+  fclose(fp);
+  return nread == *nbytes ? 0 : 1;
+}
+
+static int convert(
+    const char file_name[]
+) {
+  const char suffix[] = ".nsz";
+  const size_t nchars = strlen(file_name);
+  if (nchars < strlen(suffix) || 0 != strcmp(file_name + nchars - strlen(suffix), suffix)) {
+    fprintf(stderr, "%s: not a *.nsz file\n", file_name);
+    return 1;
+  }
+  size_t nbytes = 0;
+  unsigned char * bytes = NULL;
+  if (0 != load(file_name, &nbytes, &bytes)) {
+    fprintf(stderr, "%s: failed to load\n", file_name);
+    return 1;
+  }
+  size_t shape[2] = {0, 0};
+  size_t size = 0;
+  void * data = NULL;
+  const int retval = decompress(nbytes, bytes, shape + 0, shape + 1, &size, &data);
+  memory_free(bytes);
+  if (0 != retval) {
+    fprintf(stderr, "%s: failed to decompress\n", file_name);
+    return 1;
+  }
+  char * const npy_name = memory_alloc(nchars + 1, sizeof(char), MEMORY_TAG_IO);
+  memcpy(npy_name, file_name, nchars - strlen(suffix));
+  strcpy(npy_name + nchars - strlen(suffix), ".npy");
+  errno = 0;
+  FILE * const fp = fopen(npy_name, "w");
+  if (NULL == fp) {
+    perror(npy_name);
+    memory_free(npy_name);
+    memory_free(data);
+    return 1;
+  }
+  size_t header_size = 0;
+  const char * const dtype = sizeof(double) == size ? "'<f8'" : "'<f4'";
+  int error_code = 0;
+  if (0 != snpyio_w_header(2, shape, dtype, false, fp, &header_size)) {
+    error_code = 1;
+  } else if (shape[0] * shape[1] != fwrite(data, size, shape[0] * shape[1], fp)) {
+    error_code = 1;
+  }
+  fclose(fp);
+  if (0 == error_code) {
+    printf("%s -> %s (%zu x %zu)\n", file_name, npy_name, shape[0], shape[1]);
+  }
+  memory_free(npy_name);
+  memory_free(data);
+  return error_code;
+}
+
+int main(
+    int argc,
+    char * argv[]
+) {
+  int retval = 0;
+  for (int n = 1; n < argc; n++) {
+    retval += convert(argv[n]);
+  }
+  return retval;
+}
+
+#else
+extern char dummy;
+#endif // COMPRESS_DECODER
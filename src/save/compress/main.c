@@ -0,0 +1,580 @@
+#include <stdbool.h> // bool
+#include <stdint.h> // uint16_t, uint32_t, uint64_t, int64_t
+#include <string.h> // memcpy, memcmp
+#include <math.h> // fabs, isfinite, llround
+#include "memory.h"
+#include "logger.h"
+#include "../compress.h"
+
+// in-house compressor for floating-point arrays
+//   1. (lossy only) quantise values with the given absolute error bound
+//   2. take differences between adjacent items (delta) and map them to unsigned integers (zig-zag)
+//   3. transpose the result into byte planes (shuffle),
+//      so that the (mostly-zero) upper bytes of all items are stored next to each other
+//   4. compress each plane using an adaptive binary range coder
+// rows are grouped into blocks, which are handled independently of each other (and in parallel)
+//
+// stream layout (native byte order)
+//   magic          : 8 bytes
+//   size           : uint64_t, size of each item (4 or 8)
+//   nrows          : uint64_t
+//   ncols          : uint64_t
+//   rows_per_block : uint64_t
+//   error_bound    : double, 0 for lossless
+//   block sizes    : uint64_t x nblocks
+//   blocks
+// each block
+//   mask           : 1 byte, n-th bit is set when n-th byte plane contains non-zero values
+//   method         : 1 byte, raw (0) or range-coded (1)
+//   payload        : non-zero byte planes
+
+static const unsigned char magic[8] = {'N', 'S', 'Z', '\0', '0', '0', '0', '1'};
+
+static const size_t header_nbytes = sizeof(magic) + 5 * sizeof(uint64_t);
+
+// (approximate) number of items which are compressed together
+// NOTE: larger blocks help the adaptive model, while smaller ones give more parallelism
+static const size_t nitems_per_block = 4096;
+
+#define METHOD_RAW   0
+#define METHOD_CODED 1
+
+// parameters of the range coder (the same as LZMA)
+#define PROB_BITS 11
+#define MOVE_BITS 5
+#define TOP_VALUE ((uint32_t)1 << 24)
+
+typedef struct {
+  uint64_t low;
+  uint32_t range;
+  unsigned char cache;
+  uint64_t cache_size;
+  unsigned char * buf;
+  size_t capacity;
+  size_t pos;
+} encoder_t;
+
+typedef struct {
+  uint32_t range;
+  uint32_t code;
+  const unsigned char * buf;
+  size_t nbytes;
+  size_t pos;
+} decoder_t;
+
+static void encoder_put(
+    encoder_t * const encoder,
+    const unsigned char byte
+) {
+  // NOTE: overflow is checked by the caller after flushing
+  if (encoder->pos < encoder->capacity) {
+    encoder->buf[encoder->pos] = byte;
+  }
+  encoder->pos += 1;
+}
+
+static void encoder_shift_low(
+    encoder_t * const encoder
+) {
+  if ((uint32_t)encoder->low < 0xFF000000u || 0 != (encoder->low >> 32)) {
+    const unsigned char carry = (unsigned char)(encoder->low >> 32);
+    unsigned char byte = encoder->cache;
+    do {
+      encoder_put(encoder, (unsigned char)(byte + carry));
+      byte = 0xFF;
+    } while (0 != --encoder->cache_size);
+    encoder->cache = (unsigned char)(encoder->low >> 24);
+  }
+  encoder->cache_size += 1;
+  encoder->low = (encoder->low & 0x00FFFFFFu) << 8;
+}
+
+static void encoder_init(
+    unsigned char * const buf,
+    const size_t capacity,
+    encoder_t * const encoder
+) {
+  encoder->low = 0;
+  encoder->range = 0xFFFFFFFFu;
+  encoder->cache = 0;
+  encoder->cache_size = 1;
+  encoder->buf = buf;
+  encoder->capacity = capacity;
+  encoder->pos = 0;
+}
+
+static void encoder_flush(
+    encoder_t * const encoder
+) {
+  for (int n = 0; n < 5; n++) {
+    encoder_shift_low(encoder);
+  }
+}
+
+static void encode_bit(
+    encoder_t * const encoder,
+    uint16_t * const prob,
+    const unsigned bit
+) {
+  const uint32_t bound = (encoder->range >> PROB_BITS) * *prob;
+  if (0 == bit) {
+    encoder->range = bound;
+    *prob += ((1 << PROB_BITS) - *prob) >> MOVE_BITS;
+  } else {
+    encoder->low += bound;
+    encoder->range -= bound;
+    *prob -= *prob >> MOVE_BITS;
+  }
+  while (encoder->range < TOP_VALUE) {
+    encoder->range <<= 8;
+    encoder_shift_low(encoder);
+  }
+}
+
+static unsigned char decoder_get(
+    decoder_t * const decoder
+) {
+  // NOTE: truncated streams are padded with zeros instead of over-reading
+  if (decoder->pos < decoder->nbytes) {
+    return decoder->buf[decoder->pos++];
+  }
+  return 0;
+}
+
+static void decoder_init(
+    const unsigned char * const buf,
+    const size_t nbytes,
+    decoder_t * const decoder
+) {
+  decoder->range = 0xFFFFFFFFu;
+  decoder->code = 0;
+  decoder->buf = buf;
+  decoder->nbytes = nbytes;
+  decoder->pos = 0;
+  for (int n = 0; n < 5; n++) {
+    decoder->code = (decoder->code << 8) | decoder_get(decoder);
+  }
+}
+
+static unsigned decode_bit(
+    decoder_t * const decoder,
+    uint16_t * const prob
+) {
+  const uint32_t bound = (decoder->range >> PROB_BITS) * *prob;
+  unsigned bit = 0;
+  if (decoder->code < bound) {
+    decoder->range = bound;
+    *prob += ((1 << PROB_BITS) - *prob) >> MOVE_BITS;
+    bit = 0;
+  } else {
+    decoder->code -= bound;
+    decoder->range -= bound;
+    *prob -= *prob >> MOVE_BITS;
+    bit = 1;
+  }
+  while (decoder->range < TOP_VALUE) {
+    decoder->range <<= 8;
+    decoder->code = (decoder->code << 8) | decoder_get(decoder);
+  }
+  return bit;
+}
+
+// each byte is coded bit by bit using a binary tree of adaptive probabilities
+static void init_probs(
+    uint16_t probs[256]
+) {
+  for (size_t n = 0; n < 256; n++) {
+    probs[n] = 1 << (PROB_BITS - 1);
+  }
+}
+
+static uint64_t get_mask(
+    const size_t nbits
+) {
+  return 64 == nbits ? ~(uint64_t)0 : ((uint64_t)1 << nbits) - 1;
+}
+
+// map signed (two's complement, nbits wide) integer to unsigned one:
+//   0, -1, 1, -2, 2, ... -> 0, 1, 2, 3, 4, ...
+static uint64_t zigzag_encode(
+    const uint64_t value,
+    const size_t nbits
+) {
+  const uint64_t mask = get_mask(nbits);
+  const bool is_negative = (value >> (nbits - 1)) & 1;
+  return (is_negative ? ~(value << 1) : value << 1) & mask;
+}
+
+static uint64_t zigzag_decode(
+    const uint64_t value,
+    const size_t nbits
+) {
+  const uint64_t mask = get_mask(nbits);
+  return (value & 1 ? ~(value >> 1) : value >> 1) & mask;
+}
+
+// items -> zig-zagged differences of their integer representations
+static int forward_transform(
+    const size_t nitems,
+    const size_t size,
+    const double error_bound,
+    const unsigned char * const items,
+    uint64_t * const symbols
+) {
+  const bool is_lossy = 0. < error_bound;
+  const size_t nbits = is_lossy ? 64 : 8 * size;
+  const uint64_t mask = get_mask(nbits);
+  uint64_t prev = 0;
+  for (size_t n = 0; n < nitems; n++) {
+    uint64_t curr = 0;
+    if (is_lossy) {
+      double value = 0.;
+      if (sizeof(double) == size) {
+        memcpy(&value, items + n * size, size);
+      } else {
+        float value_ = 0.f;
+        memcpy(&value_, items + n * size, size);
+        value = value_;
+      }
+      const double ratio = value / (2. * error_bound);
+      // NOTE: keep quantised values far from the int64_t limits,
+      //       so that their differences do not overflow
+      if (!isfinite(ratio) || 4.e+18 < fabs(ratio)) {
+        return 1;
+      }
+      curr = (uint64_t)llround(ratio);
+    } else {
+      if (sizeof(uint64_t) == size) {
+        memcpy(&curr, items + n * size, size);
+      } else {
+        uint32_t curr_ = 0;
+        memcpy(&curr_, items + n * size, size);
+        curr = curr_;
+      }
+    }
+    symbols[n] = zigzag_encode((curr - prev) & mask, nbits);
+    prev = curr;
+  }
+  return 0;
+}
+
+static int backward_transform(
+    const size_t nitems,
+    const size_t size,
+    const double error_bound,
+    const uint64_t * const symbols,
+    unsigned char * const items
+) {
+  const bool is_lossy = 0. < error_bound;
+  const size_t nbits = is_lossy ? 64 : 8 * size;
+  const uint64_t mask = get_mask(nbits);
+  uint64_t curr = 0;
+  for (size_t n = 0; n < nitems; n++) {
+    curr = (curr + zigzag_decode(symbols[n], nbits)) & mask;
+    if (is_lossy) {
+      const int64_t quantised = curr >> 63 ? - (int64_t)(~curr + 1) : (int64_t)curr;
+      const double value = 2. * error_bound * quantised;
+      if (sizeof(double) == size) {
+        memcpy(items + n * size, &value, size);
+      } else {
+        const float value_ = (float)value;
+        memcpy(items + n * size, &value_, size);
+      }
+    } else {
+      if (sizeof(uint64_t) == size) {
+        memcpy(items + n * size, &curr, size);
+      } else {
+        const uint32_t curr_ = (uint32_t)curr;
+        memcpy(items + n * size, &curr_, size);
+      }
+    }
+  }
+  return 0;
+}
+
+// shuffle symbols into byte planes and compress them,
+//   returning the number of bytes written to "out"
+//   whose capacity should be (at least) 2 + nplanes * nitems
+static size_t encode_block(
+    const size_t nitems,
+    const size_t nplanes,
+    const uint64_t * const symbols,
+    unsigned char * const planes,
+    unsigned char * const out
+) {
+  unsigned char mask = 0;
+  for (size_t k = 0; k < nplanes; k++) {
+    unsigned char * const plane = planes + k * nitems;
+    unsigned char is_nonzero = 0;
+    for (size_t n = 0; n < nitems; n++) {
+      plane[n] = (unsigned char)(symbols[n] >> (8 * k));
+      is_nonzero |= plane[n];
+    }
+    if (0 != is_nonzero) {
+      mask |= (unsigned char)(1 << k);
+    }
+  }
+  out[0] = mask;
+  out[1] = METHOD_CODED;
+  size_t capacity = 0;
+  for (size_t k = 0; k < nplanes; k++) {
+    capacity += mask & (1 << k) ? nitems : 0;
+  }
+  encoder_t encoder = {0};
+  encoder_init(out + 2, capacity, &encoder);
+  for (size_t k = 0; k < nplanes; k++) {
+    if (!(mask & (1 << k))) {
+      continue;
+    }
+    const unsigned char * const plane = planes + k * nitems;
+    uint16_t probs[256];
+    init_probs(probs);
+    for (size_t n = 0; n < nitems; n++) {
+      size_t node = 1;
+      for (int bit = 7; 0 <= bit; bit--) {
+        const unsigned value = (plane[n] >> bit) & 1;
+        encode_bit(&encoder, probs + node, value);
+        node = (node << 1) | value;
+      }
+    }
+  }
+  encoder_flush(&encoder);
+  if (encoder.pos <= capacity) {
+    return 2 + encoder.pos;
+  }
+  // incompressible: store non-zero planes as they are
+  out[1] = METHOD_RAW;
+  size_t pos = 2;
+  for (size_t k = 0; k < nplanes; k++) {
+    if (mask & (1 << k)) {
+      memcpy(out + pos, planes + k * nitems, nitems);
+      pos += nitems;
+    }
+  }
+  return pos;
+}
+
+static int decode_block(
+    const size_t nitems,
+    const size_t nplanes,
+    const size_t nbytes,
+    const unsigned char * const in,
+    unsigned char * const planes,
+    uint64_t * const symbols
+) {
+  if (nbytes < 2) {
+    return 1;
+  }
+  const unsigned char mask = in[0];
+  const unsigned char method = in[1];
+  if (METHOD_RAW == method) {
+    size_t pos = 2;
+    for (size_t k = 0; k < nplanes; k++) {
+      if (mask & (1 << k)) {
+        if (nbytes < pos + nitems) {
+          return 1;
+        }
+        memcpy(planes + k * nitems, in + pos, nitems);
+        pos += nitems;
+      }
+    }
+  } else if (METHOD_CODED == method) {
+    decoder_t decoder = {0};
+    decoder_init(in + 2, nbytes - 2, &decoder);
+    for (size_t k = 0; k < nplanes; k++) {
+      if (!(mask & (1 << k))) {
+        continue;
+      }
+      unsigned char * const plane = planes + k * nitems;
+      uint16_t probs[256];
+      init_probs(probs);
+      for (size_t n = 0; n < nitems; n++) {
+        size_t node = 1;
+        for (int bit = 7; 0 <= bit; bit--) {
+          node = (node << 1) | decode_bit(&decoder, probs + node);
+        }
+        plane[n] = (unsigned char)node;
+      }
+    }
+  } else {
+    return 1;
+  }
+  for (size_t n = 0; n < nitems; n++) {
+    uint64_t symbol = 0;
+    for (size_t k = 0; k < nplanes; k++) {
+      if (mask & (1 << k)) {
+        symbol |= (uint64_t)planes[k * nitems + n] << (8 * k);
+      }
+    }
+    symbols[n] = symbol;
+  }
+  return 0;
+}
+
+static size_t get_rows_per_block(
+    const size_t ncols
+) {
+  const size_t rows_per_block = nitems_per_block / ncols;
+  return 0 == rows_per_block ? 1 : rows_per_block;
+}
+
+int compress(
+    const size_t nrows,
+    const size_t ncols,
+    const size_t size,
+    const void * const data,
+    const double error_bound,
+    size_t * const nbytes,
+    unsigned char ** const bytes
+) {
+  if (sizeof(uint32_t) != size && sizeof(uint64_t) != size) {
+    LOGGER_FAILURE("item size should be 4 or 8");
+    return 1;
+  }
+  if (0 == nrows || 0 == ncols) {
+    LOGGER_FAILURE("empty array is given");
+    return 1;
+  }
+  if (!(0. <= error_bound)) {
+    LOGGER_FAILURE("error bound should be non-negative");
+    return 1;
+  }
+  const size_t nitems = nrows * ncols;
+  const size_t nplanes = 0. < error_bound ? sizeof(uint64_t) : size;
+  const size_t rows_per_block = get_rows_per_block(ncols);
+  const size_t nblocks = (nrows + rows_per_block - 1) / rows_per_block;
+  uint64_t * const symbols = memory_alloc(nitems, sizeof(uint64_t), MEMORY_TAG_IO);
+  unsigned char * const planes = memory_alloc(nitems * nplanes, sizeof(unsigned char), MEMORY_TAG_IO);
+  unsigned char * const blocks = memory_alloc(nitems * nplanes + 2 * nblocks, sizeof(unsigned char), MEMORY_TAG_IO);
+  size_t * const block_nbytes = memory_alloc(nblocks, sizeof(size_t), MEMORY_TAG_IO);
+  int nfailures = 0;
+#pragma omp parallel for reduction(+ : nfailures)
+  for (size_t b = 0; b < nblocks; b++) {
+    const size_t row_min = b * rows_per_block;
+    const size_t row_max = row_min + rows_per_block < nrows ? row_min + rows_per_block : nrows;
+    const size_t offset = row_min * ncols;
+    const size_t block_nitems = (row_max - row_min) * ncols;
+    if (0 != forward_transform(block_nitems, size, error_bound, (const unsigned char *)data + offset * size, symbols + offset)) {
+      nfailures += 1;
+      continue;
+    }
+    block_nbytes[b] = encode_block(block_nitems, nplanes, symbols + offset, planes + offset * nplanes, blocks + offset * nplanes + 2 * b);
+  }
+  if (0 != nfailures) {
+    LOGGER_FAILURE("failed to quantise values (non-finite or too large compared to error bound)");
+    goto abort;
+  }
+  // concatenate header and blocks
+  *nbytes = header_nbytes + nblocks * sizeof(uint64_t);
+  for (size_t b = 0; b < nblocks; b++) {
+    *nbytes += block_nbytes[b];
+  }
+  *bytes = memory_alloc(*nbytes, sizeof(unsigned char), MEMORY_TAG_IO);
+  {
+    unsigned char * ptr = *bytes;
+    const uint64_t header[] = {size, nrows, ncols, rows_per_block};
+    memcpy(ptr, magic, sizeof(magic));
+    ptr += sizeof(magic);
+    memcpy(ptr, header, sizeof(header));
+    ptr += sizeof(header);
+    memcpy(ptr, &error_bound, sizeof(double));
+    ptr += sizeof(double);
+    for (size_t b = 0; b < nblocks; b++) {
+      const uint64_t block_nbytes_ = block_nbytes[b];
+      memcpy(ptr, &block_nbytes_, sizeof(uint64_t));
+      ptr += sizeof(uint64_t);
+    }
+    for (size_t b = 0; b < nblocks; b++) {
+      memcpy(ptr, blocks + b * rows_per_block * ncols * nplanes + 2 * b, block_nbytes[b]);
+      ptr += block_nbytes[b];
+    }
+  }
+  memory_free(symbols);
+  memory_free(planes);
+  memory_free(blocks);
+  memory_free(block_nbytes);
+  return 0;
+abort:
+  memory_free(symbols);
+  memory_free(planes);
+  memory_free(blocks);
+  memory_free(block_nbytes);
+  return 1;
+}
+
+int decompress(
+    const size_t nbytes,
+    const unsigned char * const bytes,
+    size_t * const nrows,
+    size_t * const ncols,
+    size_t * const size,
+    void ** const data
+) {
+  if (nbytes < header_nbytes || 0 != memcmp(bytes, magic, sizeof(magic))) {
+    LOGGER_FAILURE("not a compressed stream");
+    return 1;
+  }
+  uint64_t header[4] = {0};
+  double error_bound = 0.;
+  memcpy(header, bytes + sizeof(magic), sizeof(header));
+  memcpy(&error_bound, bytes + sizeof(magic) + sizeof(header), sizeof(double));
+  *size = header[0];
+  *nrows = header[1];
+  *ncols = header[2];
+  const size_t rows_per_block = header[3];
+  if (
+      (sizeof(uint32_t) != *size && sizeof(uint64_t) != *size)
+      || 0 == *nrows || 0 == *ncols || 0 == rows_per_block
+      || !(0. <= error_bound)
+  ) {
+    LOGGER_FAILURE("corrupted header");
+    return 1;
+  }
+  const size_t nitems = *nrows * *ncols;
+  const size_t nplanes = 0. < error_bound ? sizeof(uint64_t) : *size;
+  const size_t nblocks = (*nrows + rows_per_block - 1) / rows_per_block;
+  if (nbytes < header_nbytes + nblocks * sizeof(uint64_t)) {
+    LOGGER_FAILURE("truncated stream");
+    return 1;
+  }
+  // find where each block starts
+  size_t * const block_offsets = memory_alloc(nblocks + 1, sizeof(size_t), MEMORY_TAG_IO);
+  block_offsets[0] = header_nbytes + nblocks * sizeof(uint64_t);
+  for (size_t b = 0; b < nblocks; b++) {
+    uint64_t block_nbytes = 0;
+    memcpy(&block_nbytes, bytes + header_nbytes + b * sizeof(uint64_t), sizeof(uint64_t));
+    block_offsets[b + 1] = block_offsets[b] + block_nbytes;
+  }
+  if (nbytes < block_offsets[nblocks]) {
+    LOGGER_FAILURE("truncated stream");
+    memory_free(block_offsets);
+    return 1;
+  }
+  uint64_t * const symbols = memory_alloc(nitems, sizeof(uint64_t), MEMORY_TAG_IO);
+  unsigned char * const planes = memory_alloc(nitems * nplanes, sizeof(unsigned char), MEMORY_TAG_IO);
+  *data = memory_alloc(nitems, *size, MEMORY_TAG_IO);
+  int nfailures = 0;
+#pragma omp parallel for reduction(+ : nfailures)
+  for (size_t b = 0; b < nblocks; b++) {
+    const size_t row_min = b * rows_per_block;
+    const size_t row_max = row_min + rows_per_block < *nrows ? row_min + rows_per_block : *nrows;
+    const size_t offset = row_min * *ncols;
+    const size_t block_nitems = (row_max - row_min) * *ncols;
+    if (0 != decode_block(block_nitems, nplanes, block_offsets[b + 1] - block_offsets[b], bytes + block_offsets[b], planes + offset * nplanes, symbols + offset)) {
+      nfailures += 1;
+      continue;
+    }
+    backward_transform(block_nitems, *size, error_bound, symbols + offset, (unsigned char *)*data + offset * *size);
+  }
+  memory_free(block_offsets);
+  memory_free(symbols);
+  memory_free(planes);
+  if (0 != nfailures) {
+    LOGGER_FAILURE("corrupted block");
+    memory_free(*data);
+    *data = NULL;
+    return 1;
+  }
+  return 0;
+}
+
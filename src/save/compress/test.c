@@ -0,0 +1,220 @@
+#if defined(COMPRESS_TEST)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "memory.h"
+#include "../compress.h"
+
+#define MY_ASSERT(cond) \
+  if (!(cond)) { \
+    fprintf(stderr, "Test failed: %s (%d)\n", __func__, __LINE__); \
+    return 1; \
+  }
+
+#define REPORT_SUCCESS(objective) fprintf(stderr, "Test passed: %s (%s)\n", __func__, objective);
+
+static const double pi = 3.141592653589793238462643383;
+
+static const size_t shapes[][2] = {
+  {  1,    1},
+  {  1, 9000},
+  {  3,    7},
+  {386,  130},
+  {1000,   2},
+};
+
+// smooth signal with small noise, which mimics flow fields
+static double get_value(
+    const size_t nrows,
+    const size_t ncols,
+    const size_t j,
+    const size_t i
+) {
+  const double x = 1. * i / ncols;
+  const double y = 1. * j / nrows;
+  const double noise = 1.e-3 * rand() / RAND_MAX;
+  return sin(2. * pi * x) * cos(4. * pi * y) + noise;
+}
+
+static int test0(
+    void
+) {
+  for (size_t n = 0; n < sizeof(shapes) / sizeof(shapes[0]); n++) {
+    const size_t nrows = shapes[n][0];
+    const size_t ncols = shapes[n][1];
+    char objective[256] = {'\0'};
+    snprintf(objective, sizeof(objective) - 1, "lossless stream should recover the original float64 array: %4zu x %4zu", nrows, ncols);
+    double * const data = memory_alloc(nrows * ncols, sizeof(double), MEMORY_TAG_OTHER);
+    for (size_t j = 0; j < nrows; j++) {
+      for (size_t i = 0; i < ncols; i++) {
+        data[j * ncols + i] = get_value(nrows, ncols, j, i);
+      }
+    }
+    // special values should also be preserved
+    data[0] = - 0.;
+    data[nrows * ncols - 1] = INFINITY;
+    size_t nbytes = 0;
+    unsigned char * bytes = NULL;
+    MY_ASSERT(0 == compress(nrows, ncols, sizeof(double), data, 0., &nbytes, &bytes));
+    size_t nrows_ = 0;
+    size_t ncols_ = 0;
+    size_t size_ = 0;
+    void * data_ = NULL;
+    MY_ASSERT(0 == decompress(nbytes, bytes, &nrows_, &ncols_, &size_, &data_));
+    MY_ASSERT(nrows == nrows_);
+    MY_ASSERT(ncols == ncols_);
+    MY_ASSERT(sizeof(double) == size_);
+    MY_ASSERT(0 == memcmp(data, data_, nrows * ncols * sizeof(double)));
+    memory_free(data);
+    memory_free(data_);
+    memory_free(bytes);
+    REPORT_SUCCESS(objective);
+  }
+  return 0;
+}
+
+static int test1(
+    void
+) {
+  for (size_t n = 0; n < sizeof(shapes) / sizeof(shapes[0]); n++) {
+    const size_t nrows = shapes[n][0];
+    const size_t ncols = shapes[n][1];
+    char objective[256] = {'\0'};
+    snprintf(objective, sizeof(objective) - 1, "lossless stream should recover the original float32 array: %4zu x %4zu", nrows, ncols);
+    float * const data = memory_alloc(nrows * ncols, sizeof(float), MEMORY_TAG_OTHER);
+    for (size_t j = 0; j < nrows; j++) {
+      for (size_t i = 0; i < ncols; i++) {
+        data[j * ncols + i] = (float)get_value(nrows, ncols, j, i);
+      }
+    }
+    size_t nbytes = 0;
+    unsigned char * bytes = NULL;
+    MY_ASSERT(0 == compress(nrows, ncols, sizeof(float), data, 0., &nbytes, &bytes));
+    size_t nrows_ = 0;
+    size_t ncols_ = 0;
+    size_t size_ = 0;
+    void * data_ = NULL;
+    MY_ASSERT(0 == decompress(nbytes, bytes, &nrows_, &ncols_, &size_, &data_));
+    MY_ASSERT(sizeof(float) == size_);
+    MY_ASSERT(0 == memcmp(data, data_, nrows * ncols * sizeof(float)));
+    memory_free(data);
+    memory_free(data_);
+    memory_free(bytes);
+    REPORT_SUCCESS(objective);
+  }
+  return 0;
+}
+
+static int test2(
+    void
+) {
+  const double error_bounds[] = {1.e-2, 1.e-6, 1.e-12};
+  for (size_t n = 0; n < sizeof(shapes) / sizeof(shapes[0]); n++) {
+    for (size_t m = 0; m < sizeof(error_bounds) / sizeof(error_bounds[0]); m++) {
+      const size_t nrows = shapes[n][0];
+      const size_t ncols = shapes[n][1];
+      const double error_bound = error_bounds[m];
+      char objective[256] = {'\0'};
+      snprintf(objective, sizeof(objective) - 1, "lossy stream should satisfy the error bound %.1e: %4zu x %4zu", error_bound, nrows, ncols);
+      double * const data = memory_alloc(nrows * ncols, sizeof(double), MEMORY_TAG_OTHER);
+      for (size_t j = 0; j < nrows; j++) {
+        for (size_t i = 0; i < ncols; i++) {
+          data[j * ncols + i] = get_value(nrows, ncols, j, i);
+        }
+      }
+      size_t nbytes = 0;
+      unsigned char * bytes = NULL;
+      MY_ASSERT(0 == compress(nrows, ncols, sizeof(double), data, error_bound, &nbytes, &bytes));
+      size_t nrows_ = 0;
+      size_t ncols_ = 0;
+      size_t size_ = 0;
+      void * data_ = NULL;
+      MY_ASSERT(0 == decompress(nbytes, bytes, &nrows_, &ncols_, &size_, &data_));
+      MY_ASSERT(sizeof(double) == size_);
+      for (size_t k = 0; k < nrows * ncols; k++) {
+        const double value = ((double *)data_)[k];
+        // NOTE: allow rounding errors in the final multiplication
+        MY_ASSERT(fabs(value - data[k]) <= error_bound + 4. * DBL_EPSILON * fabs(data[k]));
+      }
+      memory_free(data);
+      memory_free(data_);
+      memory_free(bytes);
+      REPORT_SUCCESS(objective);
+    }
+  }
+  return 0;
+}
+
+static int test3(
+    void
+) {
+  const char objective[] = "smooth field should be compressed well, especially with lossy mode";
+  const size_t nrows = 386;
+  const size_t ncols = 130;
+  double * const data = memory_alloc(nrows * ncols, sizeof(double), MEMORY_TAG_OTHER);
+  for (size_t j = 0; j < nrows; j++) {
+    for (size_t i = 0; i < ncols; i++) {
+      const double x = 1. * i / ncols;
+      const double y = 1. * j / nrows;
+      data[j * ncols + i] = sin(2. * pi * x) * cos(4. * pi * y);
+    }
+  }
+  const size_t raw_nbytes = nrows * ncols * sizeof(double);
+  size_t nbytes = 0;
+  unsigned char * bytes = NULL;
+  MY_ASSERT(0 == compress(nrows, ncols, sizeof(double), data, 0., &nbytes, &bytes));
+  MY_ASSERT(nbytes < raw_nbytes);
+  memory_free(bytes);
+  MY_ASSERT(0 == compress(nrows, ncols, sizeof(double), data, 1.e-6, &nbytes, &bytes));
+  MY_ASSERT(4 * nbytes < raw_nbytes);
+  memory_free(bytes);
+  memory_free(data);
+  REPORT_SUCCESS(objective);
+  return 0;
+}
+
+static int test4(
+    void
+) {
+  const char objective[] = "invalid inputs should be rejected";
+  double data[4] = {0., 1., NAN, 3.};
+  size_t nbytes = 0;
+  unsigned char * bytes = NULL;
+  // unsupported item size
+  MY_ASSERT(0 != compress(2, 2, 2, data, 0., &nbytes, &bytes));
+  // negative error bound
+  MY_ASSERT(0 != compress(2, 2, sizeof(double), data, - 1., &nbytes, &bytes));
+  // non-finite value cannot be quantised
+  MY_ASSERT(0 != compress(2, 2, sizeof(double), data, 1.e-3, &nbytes, &bytes));
+  // broken stream
+  MY_ASSERT(0 == compress(2, 2, sizeof(double), data, 0., &nbytes, &bytes));
+  size_t nrows_ = 0;
+  size_t ncols_ = 0;
+  size_t size_ = 0;
+  void * data_ = NULL;
+  MY_ASSERT(0 != decompress(nbytes / 2, bytes, &nrows_, &ncols_, &size_, &data_));
+  bytes[0] = 'X';
+  MY_ASSERT(0 != decompress(nbytes, bytes, &nrows_, &ncols_, &size_, &data_));
+  memory_free(bytes);
+  REPORT_SUCCESS(objective);
+  return 0;
+}
+
+int main(
+    void
+) {
+  int retval = 0;
+  retval += test0();
+  retval += test1();
+  retval += test2();
+  retval += test3();
+  retval += test4();
+  return retval;
+}
+
+#else
+extern char dummy;
+#endif // COMPRESS_TEST
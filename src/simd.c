@@ -0,0 +1,17 @@
+#include "simd.h"
+
+// NOTE: the same order of preference as SIMD_DISPATCH
+const char * simd_isa(
+    void
+) {
+#if defined(SIMD_DISPATCH_ENABLED)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return "avx512f";
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return "avx2";
+  }
+#endif
+  return "default";
+}
@@ -0,0 +1,92 @@
+#include "memory.h"
+#include "array.h"
+#include "domain.h"
+#include "flow_field.h"
+#include "statistics.h"
+
+int statistics_init(
+    const domain_t * const domain,
+    statistics_t * const statistics
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  statistics->nsamples = 0;
+  memory_arena_t ** const arena = &statistics->arena;
+  *arena = memory_arena_init(9 * array_nbytes(nx + 2, ny + 2), MEMORY_TAG_FIELD);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->ux_mean);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->ux_m2);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->uy_mean);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->uy_m2);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->p_mean);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->p_m2);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->uxc_mean);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->uyc_mean);
+  array_init_arena(*arena, nx + 2, ny + 2, &statistics->uxuy_m2);
+  return 0;
+}
+
+// add the current flow field as a new sample,
+//   all quantities are updated in a single sweep
+int statistics_update(
+    const domain_t * const domain,
+    const flow_field_t * const flow_field,
+    statistics_t * const statistics
+) {
+  const size_t nx = domain->nx;
+  const size_t ny = domain->ny;
+  real_t ** const ux = flow_field->ux;
+  real_t ** const uy = flow_field->uy;
+  real_t ** const p  = flow_field->p;
+  real_t ** const ux_mean = statistics->ux_mean;
+  real_t ** const ux_m2   = statistics->ux_m2;
+  real_t ** const uy_mean = statistics->uy_mean;
+  real_t ** const uy_m2   = statistics->uy_m2;
+  real_t ** const  p_mean = statistics-> p_mean;
+  real_t ** const  p_m2   = statistics-> p_m2;
+  real_t ** const uxc_mean = statistics->uxc_mean;
+  real_t ** const uyc_mean = statistics->uyc_mean;
+  real_t ** const uxuy_m2  = statistics->uxuy_m2;
+  statistics->nsamples += 1;
+  const double factor = 1. / statistics->nsamples;
+#pragma omp parallel for
+  for (size_t j = 1; j <= ny; j++) {
+    for (size_t i = 1; i <= nx; i++) {
+      // ux, located at the cell face (i - 1/2, j)
+      {
+        const double delta = ux[j][i] - ux_mean[j][i];
+        ux_mean[j][i] += factor * delta;
+        ux_m2[j][i] += delta * (ux[j][i] - ux_mean[j][i]);
+      }
+      // uy, located at the cell face (i, j - 1/2)
+      {
+        const double delta = uy[j][i] - uy_mean[j][i];
+        uy_mean[j][i] += factor * delta;
+        uy_m2[j][i] += delta * (uy[j][i] - uy_mean[j][i]);
+      }
+      // p, located at the cell center (i, j)
+      {
+        const double delta = p[j][i] - p_mean[j][i];
+        p_mean[j][i] += factor * delta;
+        p_m2[j][i] += delta * (p[j][i] - p_mean[j][i]);
+      }
+      // co-moment of ux and uy at the cell center (i, j)
+      {
+        const double uxc = 0.5 * ux[j    ][i    ] + 0.5 * ux[j    ][i + 1];
+        const double uyc = 0.5 * uy[j    ][i    ] + 0.5 * uy[j + 1][i    ];
+        const double delta = uxc - uxc_mean[j][i];
+        uxc_mean[j][i] += factor * delta;
+        uyc_mean[j][i] += factor * (uyc - uyc_mean[j][i]);
+        uxuy_m2[j][i] += delta * (uyc - uyc_mean[j][i]);
+      }
+    }
+  }
+  return 0;
+}
+
+int statistics_finalize(
+    statistics_t * const statistics
+) {
+  memory_arena_finalize(&statistics->arena);
+  return 0;
+}
+
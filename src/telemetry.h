@@ -0,0 +1,66 @@
+#if !defined(TELEMETRY_H)
+#define TELEMETRY_H
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+// name of the POSIX shared-memory segment,
+//   which is given by the environment variable TELEMETRY_SEGMENT
+//   or "/very_simple_ns_solver.<pid>" by default, so that it is unique to each run
+#define TELEMETRY_SEGMENT_ENV "TELEMETRY_SEGMENT"
+#define TELEMETRY_SEGMENT_PREFIX "/very_simple_ns_solver."
+#define TELEMETRY_SEGMENT_LENGTH 256
+
+// stages of one time step whose wall-clock times are published:
+//   decide_dt, predict, solve_poisson, correct, update_pressure
+#define TELEMETRY_NSTAGES 5
+
+// maximum number of diagnostics and the length of their names
+#define TELEMETRY_NDIAGS_MAX 16
+#define TELEMETRY_NAME_LENGTH 16
+
+// layout of the shared-memory segment,
+//   which is protected by a sequence lock:
+//   "sequence" is odd while the writer updates the contents
+typedef struct {
+  uint64_t sequence;
+  // process id of the writer, with which readers detect stale segments
+  uint64_t pid;
+  uint64_t step;
+  double time;
+  double dt;
+  // wall-clock time (in seconds) spent in each stage of the latest step
+  double stage_times[TELEMETRY_NSTAGES];
+  // latest diagnostics
+  uint64_t ndiags;
+  char diag_names[TELEMETRY_NDIAGS_MAX][TELEMETRY_NAME_LENGTH];
+  double diag_values[TELEMETRY_NDIAGS_MAX];
+} telemetry_t;
+
+extern int telemetry_init(
+    void
+);
+
+// name of the segment, NULL when telemetry is disabled
+extern const char * telemetry_segment_name(
+    void
+);
+
+extern int telemetry_publish_step(
+    const size_t step,
+    const double time,
+    const double dt,
+    const double stage_times[TELEMETRY_NSTAGES]
+);
+
+extern int telemetry_publish_diagnostics(
+    const size_t ndiags,
+    const char * const * const names,
+    const double * const values
+);
+
+extern int telemetry_finalize(
+    void
+);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,151 @@
+// shm_open, shm_unlink, ftruncate
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h> // perror, snprintf
+#include <stdlib.h> // getenv
+#include <string.h> // strncpy
+#include <stdbool.h> // bool
+#include <errno.h> // errno
+#include <fcntl.h> // O_CREAT, O_EXCL, O_RDWR
+#include <unistd.h> // ftruncate, close, getpid
+#include <sys/mman.h> // shm_open, shm_unlink, mmap, munmap
+#include <sys/stat.h> // S_IRUSR, S_IWUSR
+#include "logger.h"
+#include "../telemetry.h"
+
+// NOTE: telemetry is optional;
+//       when the segment is not available, publishing is silently skipped
+static telemetry_t * telemetry = NULL;
+static char segment_name[TELEMETRY_SEGMENT_LENGTH] = {0};
+
+// make the contents inconsistent for readers
+static void begin_write(
+    void
+) {
+  const uint64_t sequence = __atomic_load_n(&telemetry->sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&telemetry->sequence, sequence + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// make the contents consistent again
+static void end_write(
+    void
+) {
+  const uint64_t sequence = __atomic_load_n(&telemetry->sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&telemetry->sequence, sequence + 1, __ATOMIC_RELEASE);
+}
+
+int telemetry_init(
+    void
+) {
+  const char * const name = getenv(TELEMETRY_SEGMENT_ENV);
+  const int nchars = NULL == name
+    ? snprintf(segment_name, TELEMETRY_SEGMENT_LENGTH, "%s%lld", TELEMETRY_SEGMENT_PREFIX, (long long)getpid())
+    : snprintf(segment_name, TELEMETRY_SEGMENT_LENGTH, "%s", name);
+  if (nchars < 0 || TELEMETRY_SEGMENT_LENGTH <= nchars) {
+    LOGGER_FAILURE("segment name is too long, telemetry is disabled");
+    goto abort;
+  }
+  // NOTE: an existing segment is not shared,
+  //       as it belongs to another (or a crashed) run
+  errno = 0;
+  const int fd = shm_open(segment_name, O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (-1 == fd) {
+    perror(segment_name);
+    LOGGER_FAILURE("failed to create shared-memory segment, telemetry is disabled");
+    goto abort;
+  }
+  if (0 != ftruncate(fd, sizeof(telemetry_t))) {
+    perror(segment_name);
+    LOGGER_FAILURE("failed to resize shared-memory segment, telemetry is disabled");
+    close(fd);
+    shm_unlink(segment_name);
+    goto abort;
+  }
+  void * const addr = mmap(NULL, sizeof(telemetry_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  // NOTE: mapping remains valid after the descriptor is closed
+  close(fd);
+  if (MAP_FAILED == addr) {
+    perror(segment_name);
+    LOGGER_FAILURE("failed to map shared-memory segment, telemetry is disabled");
+    shm_unlink(segment_name);
+    goto abort;
+  }
+  telemetry = addr;
+  begin_write();
+  telemetry->pid = (uint64_t)getpid();
+  telemetry->step = 0;
+  telemetry->time = 0.;
+  telemetry->dt = 0.;
+  for (size_t n = 0; n < TELEMETRY_NSTAGES; n++) {
+    telemetry->stage_times[n] = 0.;
+  }
+  telemetry->ndiags = 0;
+  end_write();
+  return 0;
+abort:
+  telemetry = NULL;
+  return 1;
+}
+
+const char * telemetry_segment_name(
+    void
+) {
+  return NULL == telemetry ? NULL : segment_name;
+}
+
+int telemetry_publish_step(
+    const size_t step,
+    const double time,
+    const double dt,
+    const double stage_times[TELEMETRY_NSTAGES]
+) {
+  if (NULL == telemetry) {
+    return 0;
+  }
+  begin_write();
+  telemetry->step = step;
+  telemetry->time = time;
+  telemetry->dt = dt;
+  for (size_t n = 0; n < TELEMETRY_NSTAGES; n++) {
+    telemetry->stage_times[n] = stage_times[n];
+  }
+  end_write();
+  return 0;
+}
+
+int telemetry_publish_diagnostics(
+    const size_t ndiags,
+    const char * const * const names,
+    const double * const values
+) {
+  if (NULL == telemetry) {
+    return 0;
+  }
+  if (TELEMETRY_NDIAGS_MAX < ndiags) {
+    LOGGER_FAILURE("too many diagnostics to be published");
+    return 1;
+  }
+  begin_write();
+  telemetry->ndiags = ndiags;
+  for (size_t n = 0; n < ndiags; n++) {
+    strncpy(telemetry->diag_names[n], names[n], TELEMETRY_NAME_LENGTH - 1);
+    telemetry->diag_names[n][TELEMETRY_NAME_LENGTH - 1] = '\0';
+    telemetry->diag_values[n] = values[n];
+  }
+  end_write();
+  return 0;
+}
+
+int telemetry_finalize(
+    void
+) {
+  if (NULL == telemetry) {
+    return 0;
+  }
+  munmap(telemetry, sizeof(telemetry_t));
+  telemetry = NULL;
+  shm_unlink(segment_name);
+  return 0;
+}
+
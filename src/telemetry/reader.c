@@ -0,0 +1,144 @@
+#if defined(TELEMETRY_READER)
+
+// shm_open, nanosleep, kill
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h> // strtod
+#include <stdint.h> // uint64_t
+#include <errno.h>
+#include <time.h> // nanosleep
+#include <signal.h> // kill
+#include <sys/types.h> // pid_t
+#include <fcntl.h> // O_RDONLY
+#include <unistd.h> // close
+#include <sys/mman.h> // shm_open, mmap, munmap
+#include "../telemetry.h"
+
+static const char * const stage_names[TELEMETRY_NSTAGES] = {
+  "decide_dt",
+  "predict",
+  "solve_poisson",
+  "correct",
+  "update_pressure",
+};
+
+// retries to take a consistent copy, between which the reader sleeps,
+//   giving up after about a second
+static const size_t max_nretries = 1000;
+static const long retry_interval = 1000000;
+
+// the writer is gone without removing the segment (e.g. crashed)
+static int is_stale(
+    const uint64_t pid
+) {
+  errno = 0;
+  return 0 != kill((pid_t)pid, 0) && ESRCH == errno;
+}
+
+// take a consistent copy of the segment:
+//   retry while the writer is updating (odd sequence)
+//   or when the sequence changed during the copy
+// NOTE: a writer which died during an update leaves the sequence odd,
+//       which is detected here rather than waiting forever
+static int read_snapshot(
+    const char name[],
+    const telemetry_t * const telemetry,
+    telemetry_t * const snapshot
+) {
+  // NOTE: assigned before the first update and unchanged afterwards
+  const uint64_t pid = __atomic_load_n(&telemetry->pid, __ATOMIC_ACQUIRE);
+  for (size_t n = 0; n < max_nretries; n++) {
+    const uint64_t sequence0 = __atomic_load_n(&telemetry->sequence, __ATOMIC_ACQUIRE);
+    if (0 == (sequence0 & 1)) {
+      *snapshot = *telemetry;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+      const uint64_t sequence1 = __atomic_load_n(&telemetry->sequence, __ATOMIC_RELAXED);
+      if (sequence0 == sequence1) {
+        return 0;
+      }
+    }
+    if (is_stale(pid)) {
+      printf("%s is stale: the writer (pid %llu) died during an update\n", name, (unsigned long long)pid);
+      return 1;
+    }
+    const struct timespec duration = {.tv_sec = 0, .tv_nsec = retry_interval};
+    nanosleep(&duration, NULL);
+  }
+  printf("%s: failed to obtain a consistent copy\n", name);
+  return 1;
+}
+
+static void print_snapshot(
+    const telemetry_t * const snapshot
+) {
+  printf("step %10llu time % .6e dt % .6e\n", (unsigned long long)snapshot->step, snapshot->time, snapshot->dt);
+  double total = 0.;
+  for (size_t n = 0; n < TELEMETRY_NSTAGES; n++) {
+    total += snapshot->stage_times[n];
+  }
+  for (size_t n = 0; n < TELEMETRY_NSTAGES; n++) {
+    printf("  %-16s % .3e s\n", stage_names[n], snapshot->stage_times[n]);
+  }
+  printf("  %-16s % .3e s\n", "total", total);
+  for (size_t n = 0; n < snapshot->ndiags && n < TELEMETRY_NDIAGS_MAX; n++) {
+    printf("  %-16s % .15e\n", snapshot->diag_names[n], snapshot->diag_values[n]);
+  }
+  fflush(stdout);
+}
+
+// usage:
+//   ./reader.out name           : print the latest values once
+//   ./reader.out name interval  : print the latest values every "interval" seconds
+// where "name" is the segment name printed by the solver at start-up
+int main(
+    int argc,
+    char * argv[]
+) {
+  if (2 != argc && 3 != argc) {
+    printf("usage: %s name [interval]\n", argv[0]);
+    return 1;
+  }
+  const char * const name = argv[1];
+  const double interval = 3 == argc ? strtod(argv[2], NULL) : 0.;
+  errno = 0;
+  const int fd = shm_open(name, O_RDONLY, 0);
+  if (-1 == fd) {
+    perror(name);
+    return 1;
+  }
+  const telemetry_t * const telemetry = mmap(NULL, sizeof(telemetry_t), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == telemetry) {
+    perror(name);
+    return 1;
+  }
+  int error_code = 0;
+  for (;;) {
+    telemetry_t snapshot = {0};
+    if (0 != read_snapshot(name, telemetry, &snapshot)) {
+      error_code = 1;
+      break;
+    }
+    print_snapshot(&snapshot);
+    if (is_stale(snapshot.pid)) {
+      printf("%s is stale: the writer (pid %llu) is not running\n", name, (unsigned long long)snapshot.pid);
+      error_code = 1;
+      break;
+    }
+    if (interval <= 0.) {
+      break;
+    }
+    const struct timespec duration = {
+      .tv_sec = (time_t)interval,
+      .tv_nsec = (long)(1.e+9 * (interval - (time_t)interval)),
+    };
+    nanosleep(&duration, NULL);
+  }
+  munmap((void *)telemetry, sizeof(telemetry_t));
+  return error_code;
+}
+
+#else
+extern char dummy;
+#endif // TELEMETRY_READER
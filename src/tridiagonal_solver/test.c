@@ -3,6 +3,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
 #include "memory.h"
 #include "tridiagonal_solver.h"
 
@@ -33,11 +36,11 @@ static int test0 (
   // answer: (+2, +1, -1, -2), (+4, +2, -2, -4)
   const size_t nitems = 4;
   const char objective[] = "non-periodic case, non-singular";
-  double * l = memory_alloc(nitems, sizeof(double));
-  double * c = memory_alloc(nitems, sizeof(double));
-  double * u = memory_alloc(nitems, sizeof(double));
-  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
-  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
+  double * l = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * c = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * u = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
+  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
   for (size_t i = 0; i < nitems; i++) {
     l[i] = + 1.;
     c[i] = - 2.;
@@ -97,11 +100,11 @@ static int test1 (
   // answer: (+1, -1, 1, -1)
   const size_t nitems = 4;
   const char objective[] = "periodic case, non-singular";
-  double * l = memory_alloc(nitems, sizeof(double));
-  double * c = memory_alloc(nitems, sizeof(double));
-  double * u = memory_alloc(nitems, sizeof(double));
-  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
-  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
+  double * l = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * c = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * u = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
+  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
   for (size_t i = 0; i < nitems; i++) {
     l[i] = + 1.;
     c[i] = - 4.;
@@ -161,11 +164,11 @@ static int test2 (
   // answer: a + (-2, -7, -4, 11)
   const size_t nitems = 4;
   const char objective[] = "periodic case, singular";
-  double * l = memory_alloc(nitems, sizeof(double));
-  double * c = memory_alloc(nitems, sizeof(double));
-  double * u = memory_alloc(nitems, sizeof(double));
-  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
-  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double));
+  double * l = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * c = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * u = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * q = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
+  double * x = memory_alloc(nitems * REPEAT_FOR, sizeof(double), MEMORY_TAG_OTHER);
   for (size_t i = 0; i < nitems; i++) {
     l[i] = + 1.;
     c[i] = - 2.;
@@ -205,6 +208,65 @@ static int test2 (
   return retval;
 }
 
+static int test3 (
+    void
+) {
+  int retval = 0;
+  // same system as test0, repeated for many times
+  //   with more threads than those at the creation of the plan
+  const size_t nitems = 4;
+  const size_t repeat_for = 64;
+  const char objective[] = "threads increased after plan creation";
+  double * l = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * c = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * u = memory_alloc(nitems, sizeof(double), MEMORY_TAG_OTHER);
+  double * x = memory_alloc(nitems * repeat_for, sizeof(double), MEMORY_TAG_OTHER);
+  double * c_offsets = memory_alloc(repeat_for, sizeof(double), MEMORY_TAG_OTHER);
+  for (size_t i = 0; i < nitems; i++) {
+    l[i] = + 1.;
+    c[i] = - 2.;
+    u[i] = + 1.;
+  }
+  for (size_t j = 0; j < repeat_for; j++) {
+    x[j * nitems + 0] = - 3.;
+    x[j * nitems + 1] = - 1.;
+    x[j * nitems + 2] = + 1.;
+    x[j * nitems + 3] = + 3.;
+  }
+  tridiagonal_solver_plan_t * plan = NULL;
+#if defined(_OPENMP)
+  const int nthreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+#endif
+  MY_ASSERT(0 == tridiagonal_solver_init_plan(nitems, repeat_for, false, &plan));
+#if defined(_OPENMP)
+  omp_set_num_threads(4 * nthreads);
+  // scratch cannot be shared by the threads of an outer team
+  int nfailures = 0;
+#pragma omp parallel reduction(+: nfailures)
+  nfailures += 0 != tridiagonal_solver_exec(plan, l, c, u, c_offsets, x) ? 1 : 0;
+  MY_ASSERT(omp_get_max_threads() == nfailures);
+#endif
+  MY_ASSERT(0 == tridiagonal_solver_exec(plan, l, c, u, c_offsets, x));
+#if defined(_OPENMP)
+  omp_set_num_threads(nthreads);
+#endif
+  for (size_t j = 0; j < repeat_for; j++) {
+    MY_ASSERT(fabs(x[j * nitems + 0] - 2.) < small);
+    MY_ASSERT(fabs(x[j * nitems + 1] - 1.) < small);
+    MY_ASSERT(fabs(x[j * nitems + 2] + 1.) < small);
+    MY_ASSERT(fabs(x[j * nitems + 3] + 2.) < small);
+  }
+  MY_ASSERT(0 == tridiagonal_solver_destroy_plan(&plan));
+  memory_free(l);
+  memory_free(c);
+  memory_free(u);
+  memory_free(x);
+  memory_free(c_offsets);
+  REPORT_SUCCESS(objective);
+  return retval;
+}
+
 int main (
     void
 ) {
@@ -212,6 +274,7 @@ int main (
   retval += test0();
   retval += test1();
   retval += test2();
+  retval += test3();
   return retval;
 }
 